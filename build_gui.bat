@@ -2,7 +2,7 @@
 echo Compiling ChronoDB GUI...
 
 
-g++ -std=c++17 -o chronodb_gui.exe -I. -I "C:/raylib/raylib/src" -I "C:/raylib/include" -L "C:/raylib/raylib/src" src/gui.cpp query/lexer.cpp query/parser.cpp storage/storage.cpp graph/graph.cpp utils/helpers.cpp utils/sorting.cpp -lraylib -lgdi32 -lwinmm
+g++ -std=c++17 -o chronodb_gui.exe -I. -I "C:/raylib/raylib/src" -I "C:/raylib/include" -L "C:/raylib/raylib/src" src/gui.cpp query/lexer.cpp query/parser.cpp storage/storage.cpp storage/buffer_pool.cpp storage/primary_index.cpp storage/free_space_map.cpp storage/zone_map.cpp storage/async_io.cpp storage/bulk_load.cpp storage/column_store.cpp storage/btree.cpp storage/mapped_file.cpp storage/file_io.cpp storage/wal.cpp graph/graph.cpp utils/helpers.cpp utils/sorting.cpp -lraylib -lgdi32 -lwinmm
 
 if %ERRORLEVEL% EQU 0 (
     echo.
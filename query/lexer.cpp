@@ -20,9 +20,10 @@ namespace ChronoDB {
     }
 
     Token Lexer::readString() {
+        char quote = current(); // "..." or '...'
         advance(); 
         string val;
-        while (current() != '"' && current() != '\0') {
+        while (current() != quote && current() != '\0') {
             val += current();
             advance();
         }
@@ -54,7 +55,7 @@ namespace ChronoDB {
 
         if (isalpha(current())) return readIdentifierOrKeyword();
         if (isdigit(current())) return readNumber();
-        if (current() == '"') return readString();
+        if (current() == '"' || current() == '\'') return readString();
 
         char c = current();
         advance();
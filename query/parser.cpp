@@ -2,6 +2,9 @@
 #include <iostream>
 #include <cmath>
 #include <cctype>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
 #include "../utils/types.h"
 #include "../utils/helpers.h"
 #include "../utils/sorting.h"
@@ -57,7 +60,7 @@ namespace ChronoDB {
 
         if (cmdUpper == "UNDO") { undo(); return; }
         if (cmdUpper == "REDO") { redo(); return; }
-        if (cmdUpper == "EXIT") { exit(0); }
+        if (cmdUpper == "EXIT") { storage.checkpoint(); exit(0); }
 
         while(!redoStack.empty()) redoStack.pop();
 
@@ -72,6 +75,8 @@ namespace ChronoDB {
         else if (cmd == "SELECT") handleSelect(tokens);
         else if (cmd == "UPDATE") handleUpdate(tokens);
         else if (cmd == "DELETE") handleDelete(tokens);
+        else if (cmd == "VACUUM") handleVacuum(tokens);
+        else if (cmd == "COPY") handleCopy(tokens);
         else if (cmd == "GRAPH") handleGraph(tokens);
         else Helper::printError("Unknown command: " + cmd);
     }
@@ -94,7 +99,7 @@ namespace ChronoDB {
         // Example: CREATE TABLE Products AVL (...)
         if (i < tokens.size() && tokens[i].value != "(") {
             string type = Helper::toUpper(tokens[i].value);
-            if (type == "AVL" || type == "BST" || type == "HASH" || type == "HEAP") {
+            if (type == "AVL" || type == "BST" || type == "HASH" || type == "HEAP" || type == "COLUMNAR" || type == "BTREE") {
                 structureType = type;
                 i++;
             }
@@ -149,8 +154,18 @@ namespace ChronoDB {
             }
         }
 
-        if (storage.createTable(tableName, columns, structureType)) {
-            Helper::printSuccess("Table '" + tableName + "' created using " + structureType + " (" + to_string(columns.size()) + " columns)");
+        // Optional COMPRESSED suffix (COLUMNAR): dictionary / run-length / delta encoded segments
+        bool compressed = false;
+        for (size_t j = i; j < tokens.size(); j++)
+            if (Helper::toUpper(tokens[j].value) == "COMPRESSED") compressed = true;
+        if (compressed && structureType != "COLUMNAR") {
+            Helper::printError("COMPRESSED is only supported for COLUMNAR tables.");
+            return;
+        }
+
+        if (storage.createTable(tableName, columns, structureType, compressed)) {
+            Helper::printSuccess("Table '" + tableName + "' created using " + structureType + (compressed ? " COMPRESSED" : "") +
+                                 " (" + to_string(columns.size()) + " columns)");
 
             undoStack.push([this, tableName]() {
                 Helper::println("[UNDO] Table removed: " + tableName);
@@ -243,7 +258,10 @@ namespace ChronoDB {
 
             undoStack.push([this, tableName, r]() {
                 int id = get<int>(r.fields[0]);
-                storage.deleteRecord(tableName, id);
+                if (!storage.deleteRecord(tableName, id)) {
+                    Helper::printError("[UNDO] Could not remove inserted row ID " + to_string(id));
+                    return;
+                }
                 Helper::printSuccess("[UNDO] Removed inserted row ID " + to_string(id));
             });
 
@@ -255,9 +273,19 @@ namespace ChronoDB {
     // ----------------------
     // SELECT
     // ----------------------
-    void Parser::handleSelect(const vector<Token>& tokens) {
+    void Parser::handleSelect(const vector<Token>& input) {
+        // SELECT <* | col[, col...]> FROM ...: the column list is taken out here, so the
+        // clauses after FROM keep their token positions below
+        size_t from = 1;
+        while (from < input.size() && Helper::toUpper(input[from].value) != "FROM") from++;
+        vector<string> selected;
+        for (size_t i = 1; i < from; ++i)
+            if (input[i].value != "," && input[i].value != "*") selected.push_back(input[i].value);
+        vector<Token> tokens = {input[0], {TokenType::SYMBOL, "*"}};
+        tokens.insert(tokens.end(), input.begin() + from, input.end());
+
         if (tokens.size() < 4) {
-            Helper::printError("Syntax: SELECT * FROM <table> [WHERE <col> <op> <val>]");
+            Helper::printError("Syntax: SELECT <*|col[,col...]> FROM <table> [WHERE <col> <op> <val>]");
             return;
         }
 
@@ -297,7 +325,6 @@ namespace ChronoDB {
              return;
         }
 
-        auto rows = storage.selectAll(tableName);
         auto columns = storage.getTableColumns(tableName);
 
         if (columns.empty()) {
@@ -305,101 +332,117 @@ namespace ChronoDB {
             return;
         }
 
+        auto findColumn = [&columns](const string& name) {
+            for (size_t i = 0; i < columns.size(); i++)
+                if (Helper::toUpper(columns[i].name) == Helper::toUpper(name)) return static_cast<int>(i);
+            return -1;
+        };
+
+        // Projection: only these columns are fetched (COLUMNAR tables read nothing else)
+        vector<uint16_t> projection;
+        for (const string& name : selected) {
+            int colIndex = findColumn(name);
+            if (colIndex == -1) {
+                Helper::printError("Column not found: " + name);
+                return;
+            }
+            projection.push_back(static_cast<uint16_t>(colIndex));
+        }
+
         // Generic WHERE clause support
-        // Syntax: WHERE <col> <op> <val>
+        // Syntax: WHERE <col> <op> <val> | WHERE <col> BETWEEN <low> AND <high>
         // Ops: =, <, >, <=, >=
-        if (tokens.size() >= 7 && Helper::toUpper(tokens[4].value) == "WHERE") {
+        optional<ScanPredicate> where;
+        int sortColumn = -1;
+        string sortType;
+        if (tokens.size() >= 8 && Helper::toUpper(tokens[4].value) == "WHERE") {
             string colName = tokens[5].value;
-            string op = tokens[6].value;
+            string op = Helper::toUpper(tokens[6].value);
             string valStr = tokens[7].value;
 
-            int colIndex = -1;
-            string colType = "";
-            for(size_t i=0; i<columns.size(); i++) {
-                if(Helper::toUpper(columns[i].name) == Helper::toUpper(colName)) {
-                    colIndex = i;
-                    colType = columns[i].type;
-                    break;
-                }
-            }
-
+            int colIndex = findColumn(colName);
             if (colIndex == -1) {
                 Helper::printError("Column not found: " + colName);
                 return;
             }
+            string colType = columns[colIndex].type;
+            auto parseValue = [&colType](const string& text) -> RecordValue {
+                if (colType == "INT") return stoi(text);
+                if (colType == "FLOAT") return stof(text);
+                return text;
+            };
 
             // FILTER LOGIC
-            // If Range Query (>, <, >=, <=) -> Use Sort + Binary Search
-            // If Equality (=) -> Use Scan (or ID lookup if implemented, but keeping generic scan/filter)
-            
-            bool isRange = (op == ">" || op == "<" || op == ">=" || op == "<=");
-
-            if (isRange) {
-                // 1. Sort Records
-                // This is O(N log N)
-                Sorting::mergeSort(rows, colIndex, colType);
-                
-                vector<Record> filtered;
-                
-                // 2. Binary Search
-                if (op == ">" || op == ">=") {
-                     // Find first element matching
-                     // For >= val: LowerBound (first element >= val)
-                     // For > val: UpperBound (first element > val)
-                     
-                     int index = -1;
-                     if (op == ">=") index = Sorting::binarySearchLowerBound(rows, colIndex, colType, valStr);
-                     else index = Sorting::binarySearchUpperBound(rows, colIndex, colType, valStr); // >
-                     
-                     // All elements from index to end are matches
-                     for(size_t i = index; i < rows.size(); i++) {
-                         filtered.push_back(rows[i]);
-                     }
-                     
-                } else if (op == "<" || op == "<=") {
-                    // For < val: LowerBound (first element >= val) -> implies everything before is < val
-                    // For <= val: UpperBound (first element > val) -> implies everything before is <= val
-                    
-                    int index = -1;
-                    if (op == "<") index = Sorting::binarySearchLowerBound(rows, colIndex, colType, valStr); // index is start of >= val, so 0..index-1 are < val
-                    else index = Sorting::binarySearchUpperBound(rows, colIndex, colType, valStr); // index is start of > val, so 0..index-1 are <= val
-                    
-                    for(size_t i = 0; i < index && i < rows.size(); i++) {
-                        filtered.push_back(rows[i]);
-                    }
-                }
-                
-                rows = filtered;
-
-            } else {
-                // LINEAR SCAN for Equality (=) or others
-                vector<Record> filtered;
-                for(auto& r : rows) {
-                    bool match = false;
-                    
-                    if (colType == "INT") {
-                        int cell = get<int>(r.fields[colIndex]);
-                        int val = stoi(valStr);
-                        if (op == "=") match = (cell == val);
-                    }
-                    else if (colType == "FLOAT") {
-                        float cell = get<float>(r.fields[colIndex]);
-                        float val = stof(valStr);
-                        if (op == "=") match = (abs(cell - val) < 0.0001);
-                    }
-                    else if (colType == "STRING") {
-                        string cell = get<string>(r.fields[colIndex]);
-                        if (op == "=") match = (cell == valStr);
-                    }
-
-                    if (match) filtered.push_back(r);
+            // The predicate is pushed into the cursor and checked on the raw row bytes,
+            // so only matching rows are materialized. Range results (>, <, >=, <=, BETWEEN)
+            // are then sorted on the column, as before.
+            ScanPredicate pred;
+            pred.column = static_cast<uint16_t>(colIndex);
+            if (op == "=") pred.op = CompareOp::EQ;
+            else if (op == "<") pred.op = CompareOp::LT;
+            else if (op == "<=") pred.op = CompareOp::LE;
+            else if (op == ">") pred.op = CompareOp::GT;
+            else if (op == ">=") pred.op = CompareOp::GE;
+            else if (op == "BETWEEN") {
+                if (tokens.size() < 10 || Helper::toUpper(tokens[8].value) != "AND") {
+                    Helper::printError("Syntax: WHERE <col> BETWEEN <low> AND <high>");
+                    return;
                 }
-                rows = filtered; 
+                pred.op = CompareOp::BETWEEN;
+                pred.high = parseValue(tokens[9].value);
+            }
+            else {
+                Helper::printError("Unsupported operator: " + op);
+                return;
             }
+
+            pred.value = parseValue(valStr);
+            where = pred;
+
+            // AVL, BST and BTREE tables return rows in id order: a range on the id
+            // needs no sort (and AVL/BTREE only visit the rows inside it)
+            using Structure = StorageEngine::StructureType;
+            Structure structure = storage.getStructureType(tableName);
+            bool idOrdered = colIndex == 0 && (structure == Structure::AVL || structure == Structure::BST ||
+                                               structure == Structure::BTREE);
+            if (op != "=" && !idOrdered) {
+                sortColumn = colIndex;
+                sortType = colType;
+            }
+        }
+
+        // A range result is sorted on its column: fetch it too if it is not projected,
+        // and drop it again after sorting
+        vector<uint16_t> fetched = projection;
+        size_t shown = projection.size();
+        if (sortColumn >= 0 && !projection.empty()) {
+            auto it = find(fetched.begin(), fetched.end(), static_cast<uint16_t>(sortColumn));
+            if (it == fetched.end()) it = fetched.insert(fetched.end(), static_cast<uint16_t>(sortColumn));
+            sortColumn = static_cast<int>(it - fetched.begin());
         }
 
+        auto cursor = storage.openCursor(tableName, where, fetched);
+        if (!cursor) {
+            Helper::printError("Table does not exist.");
+            return;
+        }
+
+        // Rows are pulled from the cursor one at a time; only matching rows arrive here
+        vector<Record> rows;
+        Record rec;
+        while (cursor->next(rec)) rows.push_back(move(rec));
+        cursor->close();
+
+        if (sortColumn >= 0) Sorting::mergeSort(rows, sortColumn, sortType);
+        if (fetched.size() > shown && shown > 0)
+            for (auto& r : rows) r.fields.resize(shown);
+
         vector<string> headers;
-        for (auto& c : columns) headers.push_back(c.name);
+        if (projection.empty()) {
+            for (auto& c : columns) headers.push_back(c.name);
+        } else {
+            for (uint16_t c : projection) headers.push_back(columns[c].name);
+        }
 
         if (rows.empty()) {
             Helper::printLine('-', 40);
@@ -408,8 +451,9 @@ namespace ChronoDB {
         }
 
         vector<vector<variant<int,float,string>>> tableRows;
-        for (auto& rec : rows)
-            tableRows.push_back(rec.fields);
+        tableRows.reserve(rows.size());
+        for (auto& r : rows)
+            tableRows.push_back(move(r.fields));
 
         Helper::printTable(tableRows, headers);
     }
@@ -437,7 +481,6 @@ namespace ChronoDB {
         int id = stoi(tokens[7].value);
 
         auto columns = storage.getTableColumns(tableName);
-        auto rows = storage.selectAll(tableName);
 
         int colIndex = -1;
         for (size_t i = 0; i < columns.size(); i++) {
@@ -452,31 +495,40 @@ namespace ChronoDB {
             return;
         }
 
-        for (auto& rec : rows) {
-            if (get<int>(rec.fields[0]) == id) {
-                Record old = rec;
+        // Targeted lookup of the old row (no full table scan)
+        auto existing = storage.getRecord(tableName, id);
+        if (!existing.has_value()) {
+            Helper::printError("ID not found.");
+            return;
+        }
 
-                if (columns[colIndex].type == "INT")
-                    rec.fields[colIndex] = stoi(newValue);
-                else if (columns[colIndex].type == "FLOAT")
-                    rec.fields[colIndex] = stof(newValue);
-                else
-                    rec.fields[colIndex] = newValue;
+        Record old = existing.value();
+        Record rec = old;
 
-                storage.updateRecord(tableName, id, rec);
+        if (columns[colIndex].type == "INT")
+            rec.fields[colIndex] = stoi(newValue);
+        else if (columns[colIndex].type == "FLOAT")
+            rec.fields[colIndex] = stof(newValue);
+        else
+            rec.fields[colIndex] = newValue;
 
-                undoStack.push([this, tableName, old]() {
-                    int oldId = get<int>(old.fields[0]);
-                    storage.updateRecord(tableName, oldId, old);
-                    Helper::println("[UNDO] Reverted update for ID " + to_string(oldId));
-                });
+        if (!storage.updateRecord(tableName, id, rec)) {
+            Helper::printError("Failed to update.");
+            return;
+        }
 
-                Helper::printSuccess("Record updated.");
+        // an update of the id column moved the row: the undo addresses it by its new id
+        int newId = get<int>(rec.fields[0]);
+        undoStack.push([this, tableName, old, newId]() {
+            int oldId = get<int>(old.fields[0]);
+            if (!storage.updateRecord(tableName, newId, old)) {
+                Helper::printError("[UNDO] Could not revert update for ID " + to_string(oldId));
                 return;
             }
-        }
+            Helper::println("[UNDO] Reverted update for ID " + to_string(oldId));
+        });
 
-        Helper::printError("ID not found.");
+        Helper::printSuccess("Record updated.");
     }
 
     // ----------------------
@@ -495,33 +547,96 @@ namespace ChronoDB {
         string tableName = tokens[2].value;
         int id = stoi(tokens[5].value);
 
-        auto rows = storage.selectAll(tableName);
-
-        bool found = false;
-        Record deleted;
-
-        for (auto& rec : rows) {
-            if (get<int>(rec.fields[0]) == id) {
-                deleted = rec;
-                found = true;
-                break;
-            }
-        }
-
-        if (!found) {
+        auto existing = storage.getRecord(tableName, id);
+        if (!existing.has_value()) {
             Helper::printError("ID not found.");
             return;
         }
+        Record deleted = existing.value();
 
-        storage.deleteRecord(tableName, id);
+        // COLUMNAR tables are append-only: the engine refuses the delete
+        if (!storage.deleteRecord(tableName, id)) {
+            Helper::printError("Failed to delete.");
+            return;
+        }
         Helper::printSuccess("Record deleted.");
 
         undoStack.push([this, tableName, deleted]() {
-            storage.insertRecord(tableName, deleted);
+            if (!storage.insertRecord(tableName, deleted)) {
+                Helper::printError("[UNDO] Could not restore deleted ID " + to_string(get<int>(deleted.fields[0])));
+                return;
+            }
             Helper::println("[UNDO] Restored deleted ID " + to_string(get<int>(deleted.fields[0])));
         });
     }
 
+    // ----------------------
+    // VACUUM
+    // ----------------------
+    void Parser::handleVacuum(const vector<Token>& tokens) {
+        if (tokens.size() < 2) {
+            Helper::printError("Syntax: VACUUM <table>");
+            return;
+        }
+
+        string tableName = tokens[1].value;
+        auto stats = storage.vacuum(tableName);
+        if (!stats.has_value()) {
+            Helper::printError("VACUUM only supported on existing HEAP tables.");
+            return;
+        }
+
+        Helper::printSuccess("Vacuumed " + tableName + ": " + to_string(stats->pagesCompacted) + " pages compacted, " +
+                             to_string(stats->pagesFreed) + " pages freed, " +
+                             to_string(stats->pagesUpgraded) + " pages converted to fixed rows, " +
+                             to_string(stats->bytesReclaimed) + " bytes reclaimed.");
+    }
+
+    // ----------------------
+    // COPY (bulk load)
+    // ----------------------
+    void Parser::handleCopy(const vector<Token>& tokens) {
+        if (tokens.size() < 4 || Helper::toUpper(tokens[2].value) != "FROM" ||
+            tokens[3].type != TokenType::STRING_LITERAL) {
+            Helper::printError("Syntax: COPY <table> FROM '<file>' [DELIMITER '<c>'] [HEADER] [PARALLEL [n]]");
+            return;
+        }
+
+        string tableName = tokens[1].value;
+        if (!storage.tableExists(tableName)) {
+            Helper::printError("Table does not exist: " + tableName);
+            return;
+        }
+
+        BulkLoadOptions options;
+        for (size_t i = 4; i < tokens.size(); ++i) {
+            string opt = Helper::toUpper(tokens[i].value);
+            if (opt == "HEADER") {
+                options.header = true;
+            } else if (opt == "DELIMITER" && i + 1 < tokens.size()) {
+                string d = tokens[++i].value;
+                options.delimiter = (d == "\\t" || Helper::toUpper(d) == "TAB") ? '\t' : d.empty() ? 0 : d[0];
+            } else if (opt == "PARALLEL") {
+                options.threads = 0; // one per core
+                if (i + 1 < tokens.size() && tokens[i + 1].type == TokenType::NUMBER)
+                    options.threads = static_cast<unsigned>(max(1, stoi(tokens[++i].value)));
+            }
+        }
+
+        auto stats = storage.bulkLoad(tableName, tokens[3].value, options);
+        if (!stats.has_value()) {
+            Helper::printError("COPY failed: cannot read '" + tokens[3].value + "' or table has no INT key column.");
+            return;
+        }
+
+        ostringstream rate;
+        rate << fixed << setprecision(2) << stats->seconds << " s, " << stats->threads << " thread(s), " << setprecision(0) << stats->rowsPerSecond()
+             << " rows/sec, " << setprecision(1) << stats->megabytesPerSecond() << " MB/sec";
+        Helper::printSuccess("Loaded " + to_string(stats->rowsLoaded) + " rows into " + tableName + " (" + rate.str() + ").");
+        if (stats->rowsRejected > 0)
+            Helper::printError(to_string(stats->rowsRejected) + " rows rejected, first at " + stats->firstError);
+    }
+
     // ----------------------
      // GRAPH COMMANDS
     // ----------------------
@@ -562,7 +677,6 @@ namespace ChronoDB {
             Graph* g = graph.getGraph(graphName);
             if (!g) return; // Error printed by getGraph
 
-           auto rows = storage.selectAll(tableName);
             auto columns = storage.getTableColumns(tableName);
             
             // Find Column Index
@@ -579,9 +693,17 @@ namespace ChronoDB {
                 return;
             }
 
-            // Import
+            auto cursor = storage.openCursor(tableName);
+            if (!cursor) {
+                Helper::printError("Table does not exist.");
+                return;
+            }
+
+            // Import (streamed row by row)
             int count = 0;
-            for(auto& r : rows) {
+            Record r;
+            while (cursor->next(r)) {
+                if (colIndex >= (int)r.fields.size()) continue;
                 string valStr;
                 // Convert to String for Vertex Name
                 if (holds_alternative<int>(r.fields[colIndex])) 
@@ -31,6 +31,8 @@ namespace ChronoDB {
         void handleUpdate(const std::vector<Token>& tokens);
         void handleDelete(const std::vector<Token>& tokens);
         void handleSelect(const std::vector<Token>& tokens);
+        void handleVacuum(const std::vector<Token>& tokens);
+        void handleCopy(const std::vector<Token>& tokens);
 
         void handleGraph(const std::vector<Token>& tokens); // NEW
     };
@@ -3,141 +3,322 @@
 
 #include "../../utils/types.h"
 #include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <vector>
 #include <optional>
+#include <stack>
 #include <iostream>
 
 namespace ChronoDB {
 
+    // Tree node without its row: 16 bytes, four to a cache line. Children are indices
+    // into the tree's node array (AVLTree::NIL for none).
     struct AVLNode {
         int id;
-        Record data;
-        AVLNode* left = nullptr;
-        AVLNode* right = nullptr;
-        int height = 1;
-
-        AVLNode(int _id, const Record& _data) : id(_id), data(_data) {}
+        uint32_t left;
+        uint32_t right;
+        int height;
     };
 
+    // Nodes live in one contiguous array and the rows in a parallel array with the same
+    // index, so a search only walks the small key nodes and touches one row at the end.
+    // Erased slots are chained on a free list (through left) and reused by inserts.
+    // Insert and erase keep the path in a fixed array instead of recursing; clear simply
+    // drops the arrays.
     class AVLTree {
+    public:
+        static constexpr uint32_t NIL = UINT32_MAX;
+
     private:
-        AVLNode* root = nullptr;
+        // AVL height <= 1.44 log2(N + 2), so 64 covers any 32-bit index space
+        static constexpr int MAX_HEIGHT = 64;
 
-        int height(AVLNode* N) {
-            return (N == nullptr) ? 0 : N->height;
-        }
+        std::vector<AVLNode> nodes;
+        std::vector<Record> rows;     // rows[i] belongs to nodes[i]
+        uint32_t root = NIL;
+        uint32_t freeList = NIL;
+        size_t count = 0;
 
-        int getBalance(AVLNode* N) {
-            return (N == nullptr) ? 0 : height(N->left) - height(N->right);
+        int height(uint32_t n) const {
+            return (n == NIL) ? 0 : nodes[n].height;
         }
 
-        AVLNode* rightRotate(AVLNode* y) {
-            AVLNode* x = y->left;
-            AVLNode* T2 = x->right;
-
-            x->right = y;
-            y->left = T2;
+        int getBalance(uint32_t n) const {
+            return (n == NIL) ? 0 : height(nodes[n].left) - height(nodes[n].right);
+        }
 
-            y->height = std::max(height(y->left), height(y->right)) + 1;
-            x->height = std::max(height(x->left), height(x->right)) + 1;
+        void updateHeight(uint32_t n) {
+            nodes[n].height = 1 + std::max(height(nodes[n].left), height(nodes[n].right));
+        }
 
+        uint32_t rightRotate(uint32_t y) {
+            uint32_t x = nodes[y].left;
+            nodes[y].left = nodes[x].right;
+            nodes[x].right = y;
+            updateHeight(y);
+            updateHeight(x);
             return x;
         }
 
-        AVLNode* leftRotate(AVLNode* x) {
-            AVLNode* y = x->right;
-            AVLNode* T2 = y->left;
-
-            y->left = x;
-            x->right = T2;
-
-            x->height = std::max(height(x->left), height(x->right)) + 1;
-            y->height = std::max(height(y->left), height(y->right)) + 1;
-
+        uint32_t leftRotate(uint32_t x) {
+            uint32_t y = nodes[x].right;
+            nodes[x].right = nodes[y].left;
+            nodes[y].left = x;
+            updateHeight(x);
+            updateHeight(y);
             return y;
         }
 
-        AVLNode* insertHelper(AVLNode* node, int id, const Record& rec) {
-            if (node == nullptr)
-                return new AVLNode(id, rec);
-
-            if (id < node->id)
-                node->left = insertHelper(node->left, id, rec);
-            else if (id > node->id)
-                node->right = insertHelper(node->right, id, rec);
-            else
-                return node; // No duplicates allowed for now
-
-            node->height = 1 + std::max(height(node->left), height(node->right));
-
+        // Restores the height and the AVL balance of node after one of its subtrees
+        // changed height by one; returns the subtree's new root
+        uint32_t rebalance(uint32_t node) {
+            updateHeight(node);
             int balance = getBalance(node);
-
-            // Left Left Case
-            if (balance > 1 && id < node->left->id)
+            if (balance > 1) {
+                if (getBalance(nodes[node].left) < 0) nodes[node].left = leftRotate(nodes[node].left); // Left Right
                 return rightRotate(node);
-
-            // Right Right Case
-            if (balance < -1 && id > node->right->id)
+            }
+            if (balance < -1) {
+                if (getBalance(nodes[node].right) > 0) nodes[node].right = rightRotate(nodes[node].right); // Right Left
                 return leftRotate(node);
+            }
+            return node;
+        }
 
-            // Left Right Case
-            if (balance > 1 && id > node->left->id) {
-                node->left = leftRotate(node->left);
-                return rightRotate(node);
+        // Points parent's link to oldChild (or the root, for no parent) at newChild
+        void relink(uint32_t parent, uint32_t oldChild, uint32_t newChild) {
+            if (parent == NIL) root = newChild;
+            else if (nodes[parent].left == oldChild) nodes[parent].left = newChild;
+            else nodes[parent].right = newChild;
+        }
+
+        // Rebalances the nodes of a root-to-node path bottom up
+        void retrace(const uint32_t* path, int depth) {
+            for (int i = depth - 1; i >= 0; --i) {
+                uint32_t top = rebalance(path[i]);
+                if (top != path[i]) relink(i > 0 ? path[i - 1] : NIL, path[i], top);
             }
+        }
 
-            // Right Left Case
-            if (balance < -1 && id < node->right->id) {
-                node->right = rightRotate(node->right);
-                return leftRotate(node);
+        uint32_t allocate(int id, const Record& rec) {
+            count++;
+            if (freeList != NIL) {
+                uint32_t n = freeList;
+                freeList = nodes[n].left;
+                nodes[n] = {id, NIL, NIL, 1};
+                rows[n] = rec;
+                return n;
             }
+            nodes.push_back({id, NIL, NIL, 1});
+            rows.push_back(rec);
+            return static_cast<uint32_t>(nodes.size() - 1);
+        }
 
-            return node;
+        void release(uint32_t n) {
+            count--;
+            rows[n] = Record{};
+            nodes[n].left = freeList;
+            freeList = n;
         }
-        
-        void inOrderHelper(AVLNode* node, std::vector<Record>& results) const {
-            if (!node) return;
-            inOrderHelper(node->left, results);
-            results.push_back(node->data);
-            inOrderHelper(node->right, results);
+
+        // Adds the row or replaces the row with the same id (upsert)
+        void insertKey(int id, const Record& rec) {
+            uint32_t path[MAX_HEIGHT];
+            int depth = 0;
+            for (uint32_t cur = root; cur != NIL; ) {
+                if (id == nodes[cur].id) {
+                    rows[cur] = rec; // existing id: the row is replaced (upsert)
+                    return;
+                }
+                path[depth++] = cur;
+                cur = (id < nodes[cur].id) ? nodes[cur].left : nodes[cur].right;
+            }
+            uint32_t n = allocate(id, rec);
+            if (depth == 0) root = n;
+            else if (id < nodes[path[depth - 1]].id) nodes[path[depth - 1]].left = n;
+            else nodes[path[depth - 1]].right = n;
+            retrace(path, depth);
         }
 
-        void clearHelper(AVLNode* node) {
-            if (!node) return;
-            clearHelper(node->left);
-            clearHelper(node->right);
-            delete node;
+        uint32_t findNode(int id) const {
+            uint32_t current = root;
+            while (current != NIL && nodes[current].id != id)
+                current = (id < nodes[current].id) ? nodes[current].left : nodes[current].right;
+            return current;
+        }
+
+        // Middle element becomes the root of each range: perfectly balanced, O(N)
+        uint32_t buildHelper(const std::vector<Record>& sorted, int lo, int hi) {
+            if (lo > hi) return NIL;
+            int mid = lo + (hi - lo) / 2;
+            uint32_t node = allocate(std::get<int>(sorted[mid].fields[0]), sorted[mid]);
+            uint32_t left = buildHelper(sorted, lo, mid - 1);
+            uint32_t right = buildHelper(sorted, mid + 1, hi);
+            nodes[node].left = left;
+            nodes[node].right = right;
+            updateHeight(node);
+            return node;
         }
 
     public:
         AVLTree() = default;
-        ~AVLTree() { clearHelper(root); }
 
         void insert(const Record& rec) {
             if (rec.fields.empty()) return;
-            try {
-                int id = std::get<int>(rec.fields[0]);
-                root = insertHelper(root, id, rec);
-            } catch (...) {
+            if (!std::holds_alternative<int>(rec.fields[0])) {
                 std::cerr << "Error: Primary Key must be INT for AVL." << std::endl;
+                return;
             }
+            insertKey(std::get<int>(rec.fields[0]), rec);
         }
 
         std::optional<Record> search(int id) const {
-            AVLNode* current = root;
-            while (current) {
-                if (id == current->id) return current->data;
-                else if (id < current->id) current = current->left;
-                else current = current->right;
+            uint32_t n = findNode(id);
+            if (n == NIL) return std::nullopt;
+            return rows[n];
+        }
+
+        // Row with this id without copying it (nullptr if absent); invalidated by writes
+        const Record* find(int id) const {
+            uint32_t n = findNode(id);
+            return n == NIL ? nullptr : &rows[n];
+        }
+
+        // Removes the row with this id, rebalancing on the way up: O(log N)
+        bool erase(int id) {
+            uint32_t path[MAX_HEIGHT];
+            int depth = 0;
+            uint32_t node = root;
+            while (node != NIL && nodes[node].id != id) {
+                path[depth++] = node;
+                node = (id < nodes[node].id) ? nodes[node].left : nodes[node].right;
+            }
+            if (node == NIL) return false;
+
+            uint32_t removed = node;
+            if (nodes[node].left != NIL && nodes[node].right != NIL) {
+                // two children: the in-order successor's key and row move up, its node goes
+                path[depth++] = node;
+                uint32_t successor = nodes[node].right;
+                while (nodes[successor].left != NIL) {
+                    path[depth++] = successor;
+                    successor = nodes[successor].left;
+                }
+                nodes[node].id = nodes[successor].id;
+                rows[node] = std::move(rows[successor]);
+                relink(path[depth - 1], successor, nodes[successor].right);
+                removed = successor;
+            } else {
+                uint32_t child = nodes[node].left != NIL ? nodes[node].left : nodes[node].right;
+                relink(depth > 0 ? path[depth - 1] : NIL, node, child);
             }
-            return std::nullopt;
+            release(removed);
+            retrace(path, depth);
+            return true;
         }
 
+        // Replaces the row with this id. If rec carries a different id the row moves to it,
+        // unless that id is already taken (false, nothing changed).
+        bool update(int id, const Record& rec) {
+            if (rec.fields.empty() || !std::holds_alternative<int>(rec.fields[0])) return false;
+            int newID = std::get<int>(rec.fields[0]);
+            uint32_t node = findNode(id);
+            if (node == NIL) return false;
+            if (newID == id) {
+                rows[node] = rec;
+                return true;
+            }
+            if (findNode(newID) != NIL) return false;
+            erase(id);
+            insertKey(newID, rec);
+            return true;
+        }
+
+        size_t size() const { return count; }
+
+        // Bytes held by the node and row arrays (not the rows' own field storage)
+        size_t memoryBytes() const {
+            return nodes.capacity() * sizeof(AVLNode) + rows.capacity() * sizeof(Record);
+        }
+
+        // In-order (ascending id) iterator with an explicit stack: O(height) memory.
+        // Invalidated by insert/erase/update/clear on the tree.
+        class InOrderIterator {
+        public:
+            InOrderIterator() = default; // empty
+
+            explicit InOrderIterator(const AVLTree& t) : tree(&t) { pushLeft(t.root); }
+
+            // Positioned at the first node with id >= key (inclusive) or id > key: the stack
+            // keeps the nodes where the descent went left, which are exactly the ones still to visit
+            InOrderIterator(const AVLTree& t, int key, bool inclusive) : tree(&t) {
+                uint32_t n = t.root;
+                while (n != NIL) {
+                    const AVLNode& node = t.nodes[n];
+                    if (node.id > key || (inclusive && node.id == key)) {
+                        path.push(n);
+                        n = node.left;
+                    } else {
+                        n = node.right;
+                    }
+                }
+            }
+
+            // Ends the traversal after the last row with id <= key
+            InOrderIterator& until(int key) {
+                last = key;
+                return *this;
+            }
+
+            // Next row, or nullptr when the traversal is done
+            const Record* next() {
+                if (path.empty() || tree->nodes[path.top()].id > last) return nullptr;
+                uint32_t n = path.top();
+                path.pop();
+                pushLeft(tree->nodes[n].right);
+                return &tree->rows[n];
+            }
+
+        private:
+            const AVLTree* tree = nullptr;
+            std::stack<uint32_t> path;
+            int last = INT_MAX;
+            void pushLeft(uint32_t n) {
+                for (; n != NIL; n = tree->nodes[n].left) path.push(n);
+            }
+        };
+
+        InOrderIterator begin() const { return InOrderIterator(*this); }
+
+        // Ordered range scans: first row with id >= key / id > key, in O(log N).
+        // E.g. ids in [a, b]: lowerBound(a).until(b), then next() until nullptr.
+        InOrderIterator lowerBound(int key) const { return InOrderIterator(*this, key, true); }
+        InOrderIterator upperBound(int key) const { return InOrderIterator(*this, key, false); }
+
         std::vector<Record> getAllSorted() const {
             std::vector<Record> results;
-            inOrderHelper(root, results);
+            results.reserve(count);
+            InOrderIterator it = begin();
+            for (const Record* rec = it.next(); rec; rec = it.next()) results.push_back(*rec);
             return results;
         }
+
+        // Bulk load (snapshot restore, COPY FROM): rows must be sorted by id without duplicates
+        void buildFromSorted(const std::vector<Record>& sorted) {
+            clear();
+            nodes.reserve(sorted.size());
+            rows.reserve(sorted.size());
+            root = buildHelper(sorted, 0, static_cast<int>(sorted.size()) - 1);
+        }
+
+        void clear() {
+            nodes.clear();
+            rows.clear();
+            root = NIL;
+            freeList = NIL;
+            count = 0;
+        }
     };
 
 } // namespace ChronoDB
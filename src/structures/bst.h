@@ -2,6 +2,7 @@
 #define CHRONODB_STRUCTURES_BST_H
 
 #include "../../utils/types.h"
+#include <cstdint>
 #include <iostream>
 #include <queue>
 #include <stack>
@@ -10,92 +11,180 @@
 
 namespace ChronoDB {
 
+    // Tree node without its row: 12 bytes. Children are indices into the tree's node
+    // array (BST::NIL for none).
     struct BSTNode {
         int id;             // Key
-        Record data;        // Value
-        BSTNode* left = nullptr;
-        BSTNode* right = nullptr;
-
-        BSTNode(int _id, const Record& _data) : id(_id), data(_data) {}
+        uint32_t left;
+        uint32_t right;
     };
 
+    // Same layout as AVLTree: nodes in one contiguous array, rows (values) in a parallel
+    // array with the same index, erased slots reused through a free list. The tree is not
+    // balanced and can degenerate into a list, so nothing here recurses along its height.
     class BST {
+    public:
+        static constexpr uint32_t NIL = UINT32_MAX;
+
     private:
-        BSTNode* root = nullptr;
+        std::vector<BSTNode> nodes;
+        std::vector<Record> rows;     // rows[i] belongs to nodes[i]
+        uint32_t root = NIL;
+        uint32_t freeList = NIL;
+        size_t count = 0;
 
-        void insertHelper(BSTNode*& node, int id, const Record& rec) {
-            if (!node) {
-                node = new BSTNode(id, rec);
-                return;
+        uint32_t allocate(int id, const Record& rec) {
+            count++;
+            if (freeList != NIL) {
+                uint32_t n = freeList;
+                freeList = nodes[n].left;
+                nodes[n] = {id, NIL, NIL};
+                rows[n] = rec;
+                return n;
             }
-            if (id < node->id) insertHelper(node->left, id, rec);
-            else insertHelper(node->right, id, rec);
+            nodes.push_back({id, NIL, NIL});
+            rows.push_back(rec);
+            return static_cast<uint32_t>(nodes.size() - 1);
+        }
+
+        void release(uint32_t n) {
+            count--;
+            rows[n] = Record{};
+            nodes[n].left = freeList;
+            freeList = n;
         }
 
-        void inOrderHelper(BSTNode* node, std::vector<Record>& results) const {
-            if (!node) return;
-            inOrderHelper(node->left, results);
-            results.push_back(node->data);
-            inOrderHelper(node->right, results);
+        // Iterative descent; equal ids go to the right subtree
+        void insertKey(int id, const Record& rec) {
+            uint32_t node = allocate(id, rec); // first: it may grow the node array
+            uint32_t* link = &root;
+            while (*link != NIL)
+                link = (id < nodes[*link].id) ? &nodes[*link].left : &nodes[*link].right;
+            *link = node;
         }
-        
-        void clearHelper(BSTNode* node) {
-            if (!node) return;
-            clearHelper(node->left);
-            clearHelper(node->right);
-            delete node;
+
+        // Balanced subtree from sorted[lo..hi]; the root is the first of a run of equal ids
+        // so that equal keys stay in the right subtree
+        uint32_t buildHelper(const std::vector<Record>& sorted, int lo, int hi) {
+            if (lo > hi) return NIL;
+            int mid = lo + (hi - lo) / 2;
+            int id = std::get<int>(sorted[mid].fields[0]);
+            while (mid > lo && std::get<int>(sorted[mid - 1].fields[0]) == id) mid--;
+            uint32_t node = allocate(id, sorted[mid]);
+            uint32_t left = buildHelper(sorted, lo, mid - 1);
+            uint32_t right = buildHelper(sorted, mid + 1, hi);
+            nodes[node].left = left;
+            nodes[node].right = right;
+            return node;
+        }
+
+        uint32_t findNode(int id) const {
+            uint32_t current = root;
+            while (current != NIL && nodes[current].id != id)
+                current = (id < nodes[current].id) ? nodes[current].left : nodes[current].right;
+            return current;
         }
 
     public:
         BST() = default;
-        ~BST() { clearHelper(root); }
 
         void insert(const Record& rec) {
             // Assume ID is the first field (Index 0) and is INT
             if (rec.fields.empty()) return;
-            try {
-                int id = std::get<int>(rec.fields[0]);
-                insertHelper(root, id, rec);
-            } catch (...) {
+            if (!std::holds_alternative<int>(rec.fields[0])) {
                 std::cerr << "Error: Primary Key must be INT for BST." << std::endl;
+                return;
             }
+            insertKey(std::get<int>(rec.fields[0]), rec);
         }
 
-        // Standard Binary Search (Recursive)
+        // Standard Binary Search (Iterative)
         std::optional<Record> search(int id) const {
-            BSTNode* current = root;
-            while (current) {
-                if (id == current->id) return current->data;
-                else if (id < current->id) current = current->left;
-                else current = current->right;
+            uint32_t n = findNode(id);
+            if (n == NIL) return std::nullopt;
+            return rows[n];
+        }
+
+        // Row with this id without copying it (nullptr if absent); invalidated by writes
+        const Record* find(int id) const {
+            uint32_t n = findNode(id);
+            return n == NIL ? nullptr : &rows[n];
+        }
+
+        // Removes the row with this id (the one search finds if the id occurs more than once).
+        // Iterative, so a degenerate tree cannot overflow the stack.
+        bool erase(int id) {
+            uint32_t* link = &root;
+            while (*link != NIL && nodes[*link].id != id)
+                link = (id < nodes[*link].id) ? &nodes[*link].left : &nodes[*link].right;
+            uint32_t node = *link;
+            if (node == NIL) return false;
+
+            if (nodes[node].left != NIL && nodes[node].right != NIL) {
+                // two children: the smallest node of the right subtree takes its place
+                uint32_t* successorLink = &nodes[node].right;
+                while (nodes[*successorLink].left != NIL) successorLink = &nodes[*successorLink].left;
+                uint32_t successor = *successorLink;
+                *successorLink = nodes[successor].right;
+                nodes[successor].left = nodes[node].left;
+                nodes[successor].right = nodes[node].right;
+                *link = successor;
+            } else {
+                *link = nodes[node].left != NIL ? nodes[node].left : nodes[node].right;
             }
-            return std::nullopt;
+            release(node);
+            return true;
+        }
+
+        // Replaces the row with this id. If rec carries a different id the row moves to it,
+        // unless that id is already taken (false, nothing changed).
+        bool update(int id, const Record& rec) {
+            if (rec.fields.empty() || !std::holds_alternative<int>(rec.fields[0])) return false;
+            int newID = std::get<int>(rec.fields[0]);
+            uint32_t node = findNode(id);
+            if (node == NIL) return false;
+            if (newID == id) {
+                rows[node] = rec;
+                return true;
+            }
+            if (findNode(newID) != NIL) return false;
+            erase(id);
+            insertKey(newID, rec);
+            return true;
+        }
+
+        size_t size() const { return count; }
+
+        // Bytes held by the node and row arrays (not the rows' own field storage)
+        size_t memoryBytes() const {
+            return nodes.capacity() * sizeof(BSTNode) + rows.capacity() * sizeof(Record);
         }
 
         // --- ALGORITHMS ---
 
         // BFS: Breadth-First Search (Level Order)
         std::optional<Record> searchBFS(int targetID) const {
-            if (!root) return std::nullopt;
+            if (root == NIL) return std::nullopt;
 
-            std::queue<BSTNode*> q;
+            std::queue<uint32_t> q;
             q.push(root);
 
             std::cout << "[BFS Traversal]: "; 
 
             while (!q.empty()) {
-                BSTNode* current = q.front();
+                uint32_t index = q.front();
+                const BSTNode& current = nodes[index];
                 q.pop();
 
-                std::cout << current->id << " "; // Visited
+                std::cout << current.id << " "; // Visited
 
-                if (current->id == targetID) {
+                if (current.id == targetID) {
                     std::cout << "(Found!)" << std::endl;
-                    return current->data;
+                    return rows[index];
                 }
 
-                if (current->left) q.push(current->left);
-                if (current->right) q.push(current->right);
+                if (current.left != NIL) q.push(current.left);
+                if (current.right != NIL) q.push(current.right);
             }
             std::cout << "(Not Found)" << std::endl;
             return std::nullopt;
@@ -103,37 +192,126 @@ namespace ChronoDB {
 
         // DFS: Depth-First Search (Pre-Order using Stack)
         std::optional<Record> searchDFS(int targetID) const {
-            if (!root) return std::nullopt;
+            if (root == NIL) return std::nullopt;
 
-            std::stack<BSTNode*> s;
+            std::stack<uint32_t> s;
             s.push(root);
 
             std::cout << "[DFS Traversal]: ";
 
             while (!s.empty()) {
-                BSTNode* current = s.top();
+                uint32_t index = s.top();
+                const BSTNode& current = nodes[index];
                 s.pop();
 
-                std::cout << current->id << " "; // Visited
+                std::cout << current.id << " "; // Visited
 
-                if (current->id == targetID) {
+                if (current.id == targetID) {
                     std::cout << "(Found!)" << std::endl;
-                    return current->data;
+                    return rows[index];
                 }
 
                 // Push right then left so left is processed first
-                if (current->right) s.push(current->right);
-                if (current->left) s.push(current->left);
+                if (current.right != NIL) s.push(current.right);
+                if (current.left != NIL) s.push(current.left);
             }
             std::cout << "(Not Found)" << std::endl;
             return std::nullopt;
         }
 
+        // In-order (ascending id) iterator with an explicit stack: O(height) memory.
+        // Invalidated by insert/erase/update/clear on the tree.
+        class InOrderIterator {
+        public:
+            explicit InOrderIterator(const BST& t) : tree(&t) { pushLeft(t.root); }
+
+            // Next row, or nullptr when the traversal is done
+            const Record* next() {
+                if (path.empty()) return nullptr;
+                uint32_t n = path.top();
+                path.pop();
+                pushLeft(tree->nodes[n].right);
+                return &tree->rows[n];
+            }
+
+        private:
+            const BST* tree;
+            std::stack<uint32_t> path;
+            void pushLeft(uint32_t n) {
+                for (; n != NIL; n = tree->nodes[n].left) path.push(n);
+            }
+        };
+
+        InOrderIterator begin() const { return InOrderIterator(*this); }
+
         std::vector<Record> getAllSorted() const {
             std::vector<Record> results;
-            inOrderHelper(root, results);
+            results.reserve(count);
+            InOrderIterator it = begin();
+            for (const Record* rec = it.next(); rec; rec = it.next()) results.push_back(*rec);
             return results;
         }
+
+        // Pre-order listing (root first): rebuilding from it gives back the exact same tree shape
+        std::vector<Record> getPreOrder() const {
+            std::vector<Record> results;
+            if (root == NIL) return results;
+            results.reserve(count);
+            std::stack<uint32_t> s;
+            s.push(root);
+            while (!s.empty()) {
+                uint32_t current = s.top();
+                s.pop();
+                results.push_back(rows[current]);
+                if (nodes[current].right != NIL) s.push(nodes[current].right);
+                if (nodes[current].left != NIL) s.push(nodes[current].left);
+            }
+            return results;
+        }
+
+        // Bulk load (snapshot restore) from a pre-order listing in O(N) using a stack
+        // of the current right spine instead of N root-to-leaf inserts
+        void buildFromPreOrder(const std::vector<Record>& list) {
+            clear();
+            nodes.reserve(list.size());
+            rows.reserve(list.size());
+            std::stack<uint32_t> spine;
+            for (const Record& rec : list) {
+                int id = std::get<int>(rec.fields[0]);
+                uint32_t node = allocate(id, rec);
+                if (root == NIL) {
+                    root = node;
+                } else if (id < nodes[spine.top()].id) {
+                    nodes[spine.top()].left = node;
+                } else {
+                    // equal keys live in the right subtree (same rule as insertKey)
+                    uint32_t parent = NIL;
+                    while (!spine.empty() && nodes[spine.top()].id <= id) {
+                        parent = spine.top();
+                        spine.pop();
+                    }
+                    nodes[parent].right = node;
+                }
+                spine.push(node);
+            }
+        }
+
+        // Bulk load (COPY FROM): rows sorted by id, builds a balanced tree in O(N)
+        void buildFromSorted(const std::vector<Record>& sorted) {
+            clear();
+            nodes.reserve(sorted.size());
+            rows.reserve(sorted.size());
+            root = buildHelper(sorted, 0, static_cast<int>(sorted.size()) - 1);
+        }
+
+        // Drops both arrays: no per-node frees, no recursion
+        void clear() {
+            nodes.clear();
+            rows.clear();
+            root = NIL;
+            freeList = NIL;
+            count = 0;
+        }
     };
 
 } // namespace ChronoDB
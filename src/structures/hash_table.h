@@ -2,65 +2,247 @@
 #define CHRONODB_STRUCTURES_HASH_H
 
 #include "../../utils/types.h"
-#include <list>
 #include <vector>
 #include <optional>
 #include <iostream>
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
 
 namespace ChronoDB {
 
-    struct HashNode {
-        int id;
-        Record data;
-        HashNode(int _id, const Record& _data) : id(_id), data(_data) {}
-    };
-
+    // Open-addressing hash table keyed by the INT primary key (Swiss-table layout).
+    //
+    // Each slot has a control byte: EMPTY, DELETED (tombstone) or the low 7 bits of the
+    // key's hash. A lookup loads the 16 control bytes at the probe position, compares all
+    // of them with the 7-bit tag at once (SSE2, scalar elsewhere) and only reads the keys
+    // of matching slots; an EMPTY byte in the group ends the search. Groups are probed
+    // in triangular steps, so every group is reached. The first GROUP control bytes are
+    // mirrored after the end so a group starting near the end can be loaded in one go.
+    //
+    // A slot holds only the key and the index of its row; rows are kept densely in
+    // insertion order, so a probe never touches a row and a resize moves only slots. Erase moves the last row into the hole.
+    // The table doubles before it is 7/8 full (tombstones included).
     class HashTable {
     private:
-        static const int TABLE_SIZE = 1009; // Prime number for better distribution
-        std::vector<std::list<HashNode>> table;
+        static constexpr size_t GROUP = 16;
+        static constexpr size_t MIN_CAPACITY = 16; // power of two, at least GROUP
+        static constexpr int8_t EMPTY = -128;
+        static constexpr int8_t DELETED = -2;
+
+        struct Slot {
+            int key;
+            uint32_t row; // index into rows
+        };
+        std::vector<int8_t> ctrl;      // capacity + GROUP bytes (the tail mirrors the first GROUP)
+        std::vector<Slot> slots;
+        std::vector<Record> rows;      // dense, insertion order (perturbed by erase)
+        size_t tombstones = 0;
 
-        int hashFunction(int id) const {
-            return id % TABLE_SIZE;
+        size_t capacity() const { return slots.size(); }
+
+        static uint64_t hashOf(int id) {
+            uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ULL;
+            return h ^ (h >> 29);
         }
+        static int8_t tagOf(uint64_t hash) { return static_cast<int8_t>(hash & 0x7F); }
 
-    public:
-        HashTable() {
-            table.resize(TABLE_SIZE);
+#if defined(__SSE2__) || defined(_M_X64)
+        // Bit i set when ctrl[pos + i] == tag
+        uint32_t matchTag(size_t pos, int8_t tag) const {
+            __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl.data() + pos));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag))));
+        }
+        // Bit i set when slot pos + i is EMPTY or DELETED (the only negative control bytes)
+        uint32_t matchFree(size_t pos) const {
+            __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl.data() + pos));
+            return static_cast<uint32_t>(_mm_movemask_epi8(group));
+        }
+#else
+        uint32_t matchTag(size_t pos, int8_t tag) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP; ++i)
+                if (ctrl[pos + i] == tag) mask |= 1u << i;
+            return mask;
+        }
+        uint32_t matchFree(size_t pos) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP; ++i)
+                if (ctrl[pos + i] < 0) mask |= 1u << i;
+            return mask;
+        }
+#endif
+        uint32_t matchEmpty(size_t pos) const { return matchTag(pos, EMPTY); }
+
+        void setCtrl(size_t slot, int8_t value) {
+            ctrl[slot] = value;
+            if (slot < GROUP) ctrl[capacity() + slot] = value;
+        }
+
+        // Slot holding id, or -1
+        long findSlot(int id) const {
+            if (rows.empty()) return -1;
+            uint64_t hash = hashOf(id);
+            int8_t tag = tagOf(hash);
+            size_t mask = capacity() - 1;
+            size_t pos = (hash >> 7) & mask;
+            for (size_t step = GROUP; ; step += GROUP) {
+                for (uint32_t m = matchTag(pos, tag); m != 0; m &= m - 1) {
+                    size_t slot = (pos + __builtin_ctz(m)) & mask;
+                    if (slots[slot].key == id) return static_cast<long>(slot);
+                }
+                if (matchEmpty(pos) != 0) return -1;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        // First EMPTY or DELETED slot on id's probe sequence (id must not be present)
+        size_t freeSlotFor(uint64_t hash) const {
+            size_t mask = capacity() - 1;
+            size_t pos = (hash >> 7) & mask;
+            for (size_t step = GROUP; ; step += GROUP) {
+                uint32_t m = matchFree(pos);
+                if (m != 0) return (pos + __builtin_ctz(m)) & mask;
+                pos = (pos + step) & mask;
+            }
+        }
+
+        void place(int id, uint32_t row) {
+            uint64_t hash = hashOf(id);
+            size_t slot = freeSlotFor(hash);
+            if (ctrl[slot] == DELETED) tombstones--;
+            setCtrl(slot, tagOf(hash));
+            slots[slot] = {id, row};
+        }
+
+        // Rebuilds the slots for newCapacity (power of two), dropping tombstones.
+        // Works from the old slots only: no row is touched.
+        void rehash(size_t newCapacity) {
+            std::vector<int8_t> oldCtrl(newCapacity + GROUP, EMPTY);
+            std::vector<Slot> oldSlots(newCapacity, Slot{0, 0});
+            oldCtrl.swap(ctrl);
+            oldSlots.swap(slots);
+            tombstones = 0;
+            for (size_t i = 0; i < oldSlots.size(); ++i)
+                if (oldCtrl[i] >= 0) place(oldSlots[i].key, oldSlots[i].row);
+        }
+
+        // Room for one more row: past 7/8 full the table doubles, or is only rebuilt in place
+        // when most of the used slots are tombstones
+        void makeRoom() {
+            if (capacity() == 0) { rehash(MIN_CAPACITY); return; }
+            if ((rows.size() + tombstones + 1) * 8 <= capacity() * 7) return;
+            rehash((rows.size() + 1) * 16 > capacity() * 7 ? capacity() * 2 : capacity());
+        }
+
+        void append(int id, const Record& rec) {
+            makeRoom();
+            rows.push_back(rec);
+            place(id, static_cast<uint32_t>(rows.size() - 1));
         }
 
-        void insert(const Record& rec) {
-            if (rec.fields.empty()) return;
-            try {
-                int id = std::get<int>(rec.fields[0]);
-                int index = hashFunction(id);
-                table[index].emplace_back(id, rec);
-            } catch (...) {
+        static std::optional<int> keyOf(const Record& rec) {
+            if (rec.fields.empty() || !std::holds_alternative<int>(rec.fields[0])) {
                 std::cerr << "Error: Primary Key must be INT for HashTable." << std::endl;
+                return std::nullopt;
             }
+            return std::get<int>(rec.fields[0]);
         }
 
-        std::optional<Record> search(int id) const {
-            int index = hashFunction(id);
-            const auto& chain = table[index];
+    public:
+        HashTable() = default;
 
-            for (const auto& node : chain) {
-                if (node.id == id) {
-                    return node.data;
-                }
+        // Adds the row unless its id is already present (returns false, row unchanged)
+        bool insert(const Record& rec) {
+            auto id = keyOf(rec);
+            if (!id.has_value() || findSlot(id.value()) >= 0) return false;
+            append(id.value(), rec);
+            return true;
+        }
+
+        // Adds the row or replaces the row with the same id
+        void upsert(const Record& rec) {
+            auto id = keyOf(rec);
+            if (!id.has_value()) return;
+            long slot = findSlot(id.value());
+            if (slot >= 0) rows[slots[slot].row] = rec;
+            else append(id.value(), rec);
+        }
+
+        bool erase(int id) {
+            long slot = findSlot(id);
+            if (slot < 0) return false;
+            uint32_t row = slots[slot].row;
+            setCtrl(static_cast<size_t>(slot), DELETED);
+            tombstones++;
+            if (row + 1 != rows.size()) {
+                // the last row fills the hole; its slot is repointed
+                rows[row] = std::move(rows.back());
+                slots[findSlot(std::get<int>(rows[row].fields[0]))].row = row;
             }
-            return std::nullopt;
+            rows.pop_back();
+            return true;
         }
 
-        std::vector<Record> getAll() const {
-            std::vector<Record> results;
-            for (const auto& chain : table) {
-                for (const auto& node : chain) {
-                    results.push_back(node.data);
-                }
+        // Replaces the row with this id. If rec carries a different id the row moves to it,
+        // unless that id is already taken (false, nothing changed).
+        bool update(int id, const Record& rec) {
+            auto newID = keyOf(rec);
+            long slot = findSlot(id);
+            if (!newID.has_value() || slot < 0) return false;
+            if (newID.value() == id) {
+                rows[slots[slot].row] = rec;
+                return true;
             }
-            return results;
+            if (findSlot(newID.value()) >= 0) return false;
+            erase(id);
+            append(newID.value(), rec);
+            return true;
+        }
+
+        std::optional<Record> search(int id) const {
+            long slot = findSlot(id);
+            if (slot < 0) return std::nullopt;
+            return rows[slots[slot].row];
         }
+
+        // Row with this id without copying it (nullptr if absent); invalidated by writes
+        const Record* find(int id) const {
+            long slot = findSlot(id);
+            return slot < 0 ? nullptr : &rows[slots[slot].row];
+        }
+
+        size_t size() const { return rows.size(); }
+
+        // Sizes the table for n rows up front (e.g. before loading a snapshot)
+        void reserve(size_t n) {
+            rows.reserve(n);
+            size_t target = MIN_CAPACITY;
+            while (n * 8 > target * 7) target *= 2;
+            if (target > capacity()) rehash(target);
+        }
+
+        std::vector<Record> getAll() const {
+            return rows;
+        }
+
+        // Walks the rows in storage order (same order as getAll). Invalidated by writes.
+        class Iterator {
+        public:
+            explicit Iterator(const std::vector<Record>& rowList) : rows(rowList) {}
+
+            // Next row, or nullptr when every row has been visited
+            const Record* next() {
+                return pos < rows.size() ? &rows[pos++] : nullptr;
+            }
+
+        private:
+            const std::vector<Record>& rows;
+            size_t pos = 0;
+        };
+
+        Iterator begin() const { return Iterator(rows); }
     };
 
 } // namespace ChronoDB
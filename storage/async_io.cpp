@@ -0,0 +1,289 @@
+// async_io.cpp
+#include "async_io.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define CHRONO_OPEN _open
+#define CHRONO_CLOSE _close
+#define CHRONO_BINARY _O_BINARY
+#else
+#include <unistd.h>
+#define CHRONO_OPEN ::open
+#define CHRONO_CLOSE ::close
+#define CHRONO_BINARY 0
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef IO_URING_OP_SUPPORTED // IORING_OP_READ and the opcode probe (Linux 5.6 headers)
+#define CHRONO_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace ChronoDB {
+
+    static constexpr uint32_t POOL_THREADS = 4;
+
+    AsyncPageReader::~AsyncPageReader() {
+        close();
+    }
+
+    bool AsyncPageReader::open(const string& path, vector<uint32_t> pages, uint32_t queueDepth) {
+        close();
+        fd = CHRONO_OPEN(path.c_str(), O_RDONLY | CHRONO_BINARY);
+        if (fd < 0) return false;
+
+        filePath = path;
+        order = move(pages);
+        depth = max<uint32_t>(1, min<uint32_t>(queueDepth, MAX_DEPTH));
+        buffers.assign(static_cast<size_t>(depth) * PAGE_SIZE, 0);
+        result.assign(depth, PENDING);
+        issued = consumed = 0;
+
+        mode = setupRing() ? Backend::IO_URING : Backend::THREAD_POOL;
+        if (mode == Backend::THREAD_POOL) startWorkers();
+
+        while (issued < order.size() && issued < depth) submit(issued++);
+        flushSubmissions();
+        return true;
+    }
+
+    void AsyncPageReader::close() {
+        if (!workers.empty()) {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            work.notify_all();
+            for (thread& t : workers) t.join();
+            workers.clear();
+            queue.clear();
+            stopping = false;
+        }
+        if (ring >= 0) {
+            // reads still in flight land in the buffers: let them finish first
+            for (size_t p = consumed; p < issued; ++p) waitFor(p);
+            teardownRing();
+        }
+        if (fd >= 0) CHRONO_CLOSE(fd);
+        fd = -1;
+        order.clear();
+        buffers.clear();
+        result.clear();
+        issued = consumed = 0;
+    }
+
+    const uint8_t* AsyncPageReader::next(uint32_t& pageIndex) {
+        if (fd < 0) return nullptr;
+        // the page handed out last time is done with: its buffer takes the next read
+        if (consumed > 0 && issued < order.size()) {
+            submit(issued++);
+            flushSubmissions();
+        }
+        if (consumed >= order.size()) return nullptr;
+
+        size_t position = consumed++;
+        waitFor(position);
+        uint8_t* page = bufferOf(position);
+        uint64_t offset = static_cast<uint64_t>(order[position]) * PAGE_SIZE;
+        int64_t got = result[position % depth];
+        if (got != static_cast<int64_t>(PAGE_SIZE)) got = readAt(fd, page, PAGE_SIZE, offset); // error or short read
+        size_t valid = got > 0 ? static_cast<size_t>(got) : 0;
+        if (valid < PAGE_SIZE) memset(page + valid, 0, PAGE_SIZE - valid);
+        pageIndex = order[position];
+        return page;
+    }
+
+    int64_t AsyncPageReader::readAt(int file, uint8_t* into, size_t bytes, uint64_t offset) {
+        size_t done = 0;
+        while (done < bytes) {
+#ifdef _WIN32
+            if (_lseeki64(file, static_cast<long long>(offset + done), SEEK_SET) < 0) break;
+            int n = _read(file, into + done, static_cast<unsigned int>(bytes - done));
+#else
+            ssize_t n = ::pread(file, into + done, bytes - done, static_cast<off_t>(offset + done));
+            if (n < 0 && errno == EINTR) continue;
+#endif
+            if (n <= 0) break;
+            done += static_cast<size_t>(n);
+        }
+        return static_cast<int64_t>(done);
+    }
+
+    // ---- thread pool ----
+
+    void AsyncPageReader::startWorkers() {
+        uint32_t count = min(depth, POOL_THREADS);
+        for (uint32_t i = 0; i < count; ++i) workers.emplace_back(&AsyncPageReader::workerLoop, this);
+    }
+
+    void AsyncPageReader::workerLoop() {
+        int file = CHRONO_OPEN(filePath.c_str(), O_RDONLY | CHRONO_BINARY);
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            work.wait(guard, [this] { return stopping || !queue.empty(); });
+            if (stopping) break;
+            size_t position = queue.front();
+            queue.pop_front();
+            uint8_t* into = bufferOf(position);
+            uint64_t offset = static_cast<uint64_t>(order[position]) * PAGE_SIZE;
+
+            guard.unlock();
+            int64_t got = file >= 0 ? readAt(file, into, PAGE_SIZE, offset) : -1;
+            guard.lock();
+            result[position % depth] = got;
+            finished.notify_all();
+        }
+        guard.unlock();
+        if (file >= 0) CHRONO_CLOSE(file);
+    }
+
+    void AsyncPageReader::submit(size_t position) {
+        if (mode == Backend::IO_URING) {
+            ringSubmit(position);
+            return;
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            result[position % depth] = PENDING;
+            queue.push_back(position);
+        }
+        work.notify_one();
+    }
+
+    void AsyncPageReader::waitFor(size_t position) {
+        if (mode == Backend::IO_URING) {
+            ringWait(position);
+            return;
+        }
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&] { return result[position % depth] != PENDING; });
+    }
+
+    // ---- io_uring ----
+
+#ifdef CHRONO_IO_URING
+    static uint32_t* ringField(void* base, uint32_t offset) {
+        return reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(base) + offset);
+    }
+
+    bool AsyncPageReader::setupRing() {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        long r = syscall(__NR_io_uring_setup, depth, &params);
+        if (r < 0) return false; // no kernel support, or blocked (e.g. by a seccomp profile)
+        ring = static_cast<int>(r);
+
+        // IORING_OP_READ needs Linux 5.6; older kernels get the thread pool
+        vector<uint8_t> probeBytes(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+        auto* probe = reinterpret_cast<io_uring_probe*>(probeBytes.data());
+        if (syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+            probe->last_op < IORING_OP_READ || !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)) {
+            teardownRing();
+            return false;
+        }
+
+        sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sqRingBytes = cqRingBytes = max(sqRingBytes, cqRingBytes);
+
+        sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) sqRing = nullptr;
+        cqRing = single ? sqRing : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) cqRing = nullptr;
+        sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) sqes = nullptr;
+        if (!sqRing || !cqRing || !sqes) {
+            teardownRing();
+            return false;
+        }
+
+        sqHead = ringField(sqRing, params.sq_off.head);
+        sqTail = ringField(sqRing, params.sq_off.tail);
+        sqMask = ringField(sqRing, params.sq_off.ring_mask);
+        sqArray = ringField(sqRing, params.sq_off.array);
+        cqHead = ringField(cqRing, params.cq_off.head);
+        cqTail = ringField(cqRing, params.cq_off.tail);
+        cqMask = ringField(cqRing, params.cq_off.ring_mask);
+        cqes = static_cast<uint8_t*>(cqRing) + params.cq_off.cqes;
+        pendingSubmissions = 0;
+        return true;
+    }
+
+    void AsyncPageReader::teardownRing() {
+        if (sqes) munmap(sqes, sqesBytes);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingBytes);
+        if (sqRing) munmap(sqRing, sqRingBytes);
+        sqes = sqRing = cqRing = cqes = nullptr;
+        if (ring >= 0) CHRONO_CLOSE(ring);
+        ring = -1;
+    }
+
+    void AsyncPageReader::ringSubmit(size_t position) {
+        result[position % depth] = PENDING;
+        uint32_t tail = *sqTail; // this thread is the only producer
+        uint32_t index = tail & *sqMask;
+        io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes) + index;
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(bufferOf(position));
+        sqe->len = PAGE_SIZE;
+        sqe->off = static_cast<uint64_t>(order[position]) * PAGE_SIZE;
+        sqe->user_data = position;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        pendingSubmissions++;
+    }
+
+    void AsyncPageReader::flushSubmissions() {
+        if (mode != Backend::IO_URING || pendingSubmissions == 0) return;
+        long r = syscall(__NR_io_uring_enter, ring, pendingSubmissions, 0, 0, nullptr, 0);
+        if (r > 0) pendingSubmissions -= min<uint32_t>(pendingSubmissions, static_cast<uint32_t>(r));
+        // on failure the entries stay queued and go in with the next wait
+    }
+
+    void AsyncPageReader::reapCompletions() {
+        uint32_t head = *cqHead;
+        uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes) + (head & *cqMask);
+            result[cqe->user_data % depth] = cqe->res;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    void AsyncPageReader::ringWait(size_t position) {
+        size_t b = position % depth;
+        while (true) {
+            reapCompletions();
+            if (result[b] != PENDING) return;
+            long r = syscall(__NR_io_uring_enter, ring, pendingSubmissions, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (r > 0) pendingSubmissions -= min<uint32_t>(pendingSubmissions, static_cast<uint32_t>(r));
+            else if (r < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                result[b] = -errno; // next() reads the page synchronously
+                return;
+            }
+        }
+    }
+#else
+    bool AsyncPageReader::setupRing() { return false; }
+    void AsyncPageReader::teardownRing() {}
+    void AsyncPageReader::reapCompletions() {}
+    void AsyncPageReader::flushSubmissions() {}
+    void AsyncPageReader::ringSubmit(size_t) {}
+    void AsyncPageReader::ringWait(size_t) {}
+#endif
+
+} // namespace ChronoDB
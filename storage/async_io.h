@@ -0,0 +1,95 @@
+#ifndef CHRONODB_ASYNC_IO_H
+#define CHRONODB_ASYNC_IO_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include "page.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Reads a list of pages of one file ahead of its consumer, keeping up to `depth`
+    // reads in flight, so a scan decodes one page while the next ones are on their way.
+    //
+    // Backends: io_uring on Linux (raw syscalls, no liburing), otherwise a small pool
+    // of threads issuing positional reads. Pages are handed out in list order; each
+    // buffer is reused for a new read once the consumer asks for the following page.
+    // A failed asynchronous read is retried synchronously, and bytes past the end of
+    // the file read as zero, as in BufferPool.
+    class AsyncPageReader {
+    public:
+        enum class Backend { IO_URING, THREAD_POOL };
+        static constexpr uint32_t MAX_DEPTH = 256;
+
+        AsyncPageReader() = default;
+        ~AsyncPageReader();
+        AsyncPageReader(const AsyncPageReader&) = delete;
+        AsyncPageReader& operator=(const AsyncPageReader&) = delete;
+
+        // pages: page indexes to read, in the order next() returns them
+        bool open(const string& path, vector<uint32_t> pages, uint32_t depth);
+        void close();
+        bool isOpen() const { return fd >= 0; }
+
+        // Next page of the list (blocks until it has been read); nullptr after the last.
+        // The bytes stay valid until the following call.
+        const uint8_t* next(uint32_t& pageIndex);
+
+        Backend backend() const { return mode; }
+        static const char* backendName(Backend b) { return b == Backend::IO_URING ? "io_uring" : "thread pool"; }
+
+    private:
+        int fd = -1;
+        string filePath;
+        Backend mode = Backend::THREAD_POOL;
+        vector<uint32_t> order;
+        uint32_t depth = 0;
+        size_t issued = 0;    // list positions submitted so far
+        size_t consumed = 0;  // list positions handed to the consumer
+        vector<uint8_t> buffers;  // depth pages; position p lives in buffer p % depth
+        vector<int64_t> result;   // per buffer: bytes read, -errno, or PENDING
+        static constexpr int64_t PENDING = INT64_MIN;
+
+        // io_uring state (mapped rings)
+        int ring = -1;
+        void* sqRing = nullptr;
+        void* cqRing = nullptr;
+        void* sqes = nullptr;
+        size_t sqRingBytes = 0, cqRingBytes = 0, sqesBytes = 0;
+        uint32_t *sqHead = nullptr, *sqTail = nullptr, *sqMask = nullptr, *sqArray = nullptr;
+        uint32_t *cqHead = nullptr, *cqTail = nullptr, *cqMask = nullptr;
+        void* cqes = nullptr;
+
+        // thread pool state (each worker reads through its own descriptor)
+        vector<thread> workers;
+        mutex lock;
+        condition_variable work, finished;
+        deque<size_t> queue;  // list positions waiting for a worker
+        bool stopping = false;
+
+        bool setupRing();
+        void teardownRing();
+        void ringSubmit(size_t position);
+        void ringWait(size_t position);
+        void startWorkers();
+        void workerLoop();
+
+        void submit(size_t position);
+        void flushSubmissions();  // io_uring: enters the queued submissions
+        void waitFor(size_t position);
+        void reapCompletions();
+        uint8_t* bufferOf(size_t position) { return buffers.data() + (position % depth) * PAGE_SIZE; }
+
+        uint32_t pendingSubmissions = 0;  // queued in the ring, not yet entered
+
+        static int64_t readAt(int file, uint8_t* into, size_t bytes, uint64_t offset);
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_ASYNC_IO_H
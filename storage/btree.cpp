@@ -0,0 +1,455 @@
+// btree.cpp
+#include "btree.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+using namespace std;
+
+namespace ChronoDB {
+
+    static constexpr size_t META_RECORD_BYTES = 28;
+    static constexpr size_t MAX_DEPTH = 64; // deeper than any real tree: the file is damaged
+
+    // ---------- node helpers ----------
+
+    int BPlusTree::keyAt(const Page& node, uint16_t i) {
+        int key = 0;
+        memcpy(&key, node.data.data() + node.slots[i].offset, 4);
+        return key;
+    }
+
+    uint32_t BPlusTree::childAt(const Page& node, uint16_t i) {
+        if (i == 0) return node.link;
+        uint32_t child = 0;
+        memcpy(&child, node.data.data() + node.slots[i - 1].offset + 4, 4);
+        return child;
+    }
+
+    // First slot whose key is >= key
+    uint16_t BPlusTree::lowerBound(const Page& node, int key) {
+        uint16_t lo = 0, hi = static_cast<uint16_t>(node.slots.size());
+        while (lo < hi) {
+            uint16_t mid = static_cast<uint16_t>((lo + hi) / 2);
+            if (keyAt(node, mid) < key) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // Child of an internal node whose range holds key: the number of separators <= key
+    uint16_t BPlusTree::childIndexFor(const Page& node, int key) {
+        uint16_t lo = 0, hi = static_cast<uint16_t>(node.slots.size());
+        while (lo < hi) {
+            uint16_t mid = static_cast<uint16_t>((lo + hi) / 2);
+            if (keyAt(node, mid) <= key) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    size_t BPlusTree::usedBytes(const Page& node) {
+        size_t used = 0;
+        for (const SlotEntry& s : node.slots) used += s.length + sizeof(SlotEntry);
+        return used;
+    }
+
+    // Puts an entry at slot position pos (later slots move up one), compacting if that makes room
+    bool BPlusTree::insertAt(Page& node, uint16_t pos, const Entry& entry) {
+        size_t need = entry.size() + sizeof(SlotEntry);
+        if (node.freeSpace() < need && node.deadBytes() > 0) node.compact();
+        if (node.freeSpace() < need) return false;
+        memcpy(node.data.data() + node.freeSpaceOffset, entry.data(), entry.size());
+        node.slots.insert(node.slots.begin() + pos, SlotEntry(node.freeSpaceOffset, static_cast<uint16_t>(entry.size())));
+        node.freeSpaceOffset = static_cast<uint16_t>(node.freeSpaceOffset + entry.size());
+        node.slotCount = static_cast<uint16_t>(node.slots.size());
+        return true;
+    }
+
+    void BPlusTree::removeAt(Page& node, uint16_t pos) {
+        node.slots.erase(node.slots.begin() + pos);
+        node.slotCount = static_cast<uint16_t>(node.slots.size());
+        if (node.deadBytes() >= PAGE_COMPACT_THRESHOLD) node.compact();
+    }
+
+    vector<BPlusTree::Entry> BPlusTree::entries(const Page& node) {
+        vector<Entry> all;
+        all.reserve(node.slots.size());
+        for (const SlotEntry& s : node.slots)
+            all.emplace_back(node.data.begin() + s.offset, node.data.begin() + s.offset + s.length);
+        return all;
+    }
+
+    // Replaces the node's entries (header fields are kept); the caller made sure they fit
+    void BPlusTree::fill(Page& node, vector<Entry>::const_iterator first, vector<Entry>::const_iterator last) {
+        node.slots.clear();
+        fill_n(node.data.begin() + PAGE_HEADER_RESERVED, PAGE_SIZE - PAGE_HEADER_RESERVED, 0);
+        node.freeSpaceOffset = PAGE_HEADER_RESERVED;
+        for (auto it = first; it != last; ++it) {
+            memcpy(node.data.data() + node.freeSpaceOffset, it->data(), it->size());
+            node.slots.emplace_back(node.freeSpaceOffset, static_cast<uint16_t>(it->size()));
+            node.freeSpaceOffset = static_cast<uint16_t>(node.freeSpaceOffset + it->size());
+        }
+        node.slotCount = static_cast<uint16_t>(node.slots.size());
+    }
+
+    size_t BPlusTree::fitBytes(vector<Entry>::const_iterator first, vector<Entry>::const_iterator last) {
+        size_t bytes = 0;
+        for (auto it = first; it != last; ++it) bytes += it->size() + sizeof(SlotEntry);
+        return bytes;
+    }
+
+    // Split point m with the bytes of [0, m) and [m, n) as even as possible, both non-empty.
+    // dropMiddle (internal nodes): entry m moves up to the parent, the right half is [m + 1, n).
+    size_t BPlusTree::balancedSplit(const vector<Entry>& all, bool dropMiddle) {
+        size_t total = fitBytes(all.begin(), all.end());
+        size_t best = 1, bestLarger = SIZE_MAX, left = 0;
+        size_t last = dropMiddle ? all.size() - 2 : all.size() - 1;
+        for (size_t m = 1; m <= last; ++m) {
+            left += all[m - 1].size() + sizeof(SlotEntry);
+            size_t right = total - left - (dropMiddle ? all[m].size() + sizeof(SlotEntry) : 0);
+            size_t larger = max(left, right);
+            if (larger < bestLarger) {
+                bestLarger = larger;
+                best = m;
+            }
+        }
+        return best;
+    }
+
+    BPlusTree::Entry BPlusTree::makeEntry(int key, const void* payload, size_t bytes) {
+        Entry entry(4 + bytes);
+        memcpy(entry.data(), &key, 4);
+        if (bytes > 0) memcpy(entry.data() + 4, payload, bytes);
+        return entry;
+    }
+
+    // ---------- pages ----------
+
+    bool BPlusTree::readNode(uint32_t pageID, Page& out) const {
+        const Page* frame = pool->pinPage(path, pageID);
+        if (!frame) return false;
+        out = *frame;
+        pool->unpinPage(path, pageID, false);
+        return true;
+    }
+
+    bool BPlusTree::writeNode(const Page& node) {
+        Page* frame = pool->pinPage(path, node.pageID, false);
+        if (!frame) return false;
+        *frame = node;
+        pool->unpinPage(path, node.pageID, true);
+        return true;
+    }
+
+    Page BPlusTree::metaPage() const {
+        vector<uint8_t> record(META_RECORD_BYTES, 0);
+        memcpy(record.data(), "CBPT", 4);
+        record[4] = VERSION;
+        memcpy(record.data() + 8, &root, 4);
+        memcpy(record.data() + 12, &pages, 4);
+        memcpy(record.data() + 16, &freeHead, 4);
+        memcpy(record.data() + 20, &rows, 8);
+        Page meta;
+        meta.pageID = 0;
+        meta.kind = PAGE_KIND_BTREE_META;
+        meta.insertRawRecord(record);
+        return meta;
+    }
+
+    bool BPlusTree::writeMeta() {
+        return writeNode(metaPage());
+    }
+
+    uint32_t BPlusTree::allocate() {
+        if (freeHead == 0) return pages++;
+        uint32_t pageID = freeHead;
+        Page free;
+        readNode(pageID, free);
+        freeHead = free.link;
+        return pageID;
+    }
+
+    void BPlusTree::release(uint32_t pageID) {
+        Page free;
+        free.pageID = pageID;
+        free.kind = PAGE_KIND_FREE;
+        free.link = freeHead;
+        writeNode(free);
+        freeHead = pageID;
+    }
+
+    bool BPlusTree::create() {
+        pool->discardFile(path);
+        root = 1;
+        pages = 2;
+        freeHead = 0;
+        rows = 0;
+
+        Page leaf;
+        leaf.pageID = root;
+        leaf.kind = PAGE_KIND_BTREE_LEAF;
+        leaf.rowFormat = ROW_FORMAT_FIXED;
+
+        ofstream file(path, ios::binary | ios::trunc);
+        if (!file) return false;
+        vector<uint8_t> buffer;
+        for (const Page& p : {metaPage(), leaf}) {
+            p.serializeToBuffer(buffer);
+            file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool BPlusTree::open() {
+        Page meta;
+        if (!readNode(0, meta) || meta.kind != PAGE_KIND_BTREE_META) return false;
+        const uint8_t* record = nullptr;
+        uint16_t len = 0;
+        if (!meta.recordBytes(0, record, len) || len < META_RECORD_BYTES) return false;
+        if (memcmp(record, "CBPT", 4) != 0 || record[4] != VERSION) return false;
+        memcpy(&root, record + 8, 4);
+        memcpy(&pages, record + 12, 4);
+        memcpy(&freeHead, record + 16, 4);
+        memcpy(&rows, record + 20, 8);
+        return true;
+    }
+
+    // ---------- lookups ----------
+
+    // Root-to-leaf walk for key, remembering the internal nodes passed
+    bool BPlusTree::descend(int key, vector<Step>& steps, Page& leaf) const {
+        uint32_t pageID = root;
+        Page node;
+        while (steps.size() < MAX_DEPTH) {
+            if (!readNode(pageID, node)) return false;
+            if (node.kind == PAGE_KIND_BTREE_LEAF) {
+                leaf = move(node);
+                return true;
+            }
+            if (node.kind != PAGE_KIND_BTREE_INTERNAL) return false;
+            uint16_t child = childIndexFor(node, key);
+            steps.push_back({pageID, child});
+            pageID = childAt(node, child);
+        }
+        return false;
+    }
+
+    // Pins each node on the way down instead of copying it: one page read per level
+    bool BPlusTree::find(int key, vector<uint8_t>& row) const {
+        uint32_t pageID = root;
+        for (size_t depth = 0; depth < MAX_DEPTH; ++depth) {
+            const Page* node = pool->pinPage(path, pageID);
+            if (!node) return false;
+            if (node->kind == PAGE_KIND_BTREE_LEAF) {
+                uint16_t pos = lowerBound(*node, key);
+                bool found = pos < node->slots.size() && keyAt(*node, pos) == key;
+                if (found) {
+                    const SlotEntry& s = node->slots[pos];
+                    row.assign(node->data.begin() + s.offset + 4, node->data.begin() + s.offset + s.length);
+                }
+                pool->unpinPage(path, pageID, false);
+                return found;
+            }
+            uint32_t child = 0;
+            bool internal = node->kind == PAGE_KIND_BTREE_INTERNAL;
+            if (internal) child = childAt(*node, childIndexFor(*node, key));
+            pool->unpinPage(path, pageID, false);
+            if (!internal) return false;
+            pageID = child;
+        }
+        return false;
+    }
+
+    uint32_t BPlusTree::height() const {
+        uint32_t levels = 0;
+        uint32_t pageID = root;
+        Page node;
+        while (levels < MAX_DEPTH && readNode(pageID, node)) {
+            levels++;
+            if (node.kind != PAGE_KIND_BTREE_INTERNAL) break;
+            pageID = node.link;
+        }
+        return levels;
+    }
+
+    BPlusTree::Iterator BPlusTree::seek(int from) const {
+        Iterator it;
+        vector<Step> steps;
+        it.tree = this;
+        if (descend(from, steps, it.leaf)) {
+            it.slot = lowerBound(it.leaf, from);
+            it.done = false;
+        }
+        return it;
+    }
+
+    bool BPlusTree::Iterator::next(int& key, const uint8_t*& row, uint16_t& len) {
+        while (!done) {
+            if (slot < leaf.slots.size()) {
+                const SlotEntry& s = leaf.slots[slot++];
+                const uint8_t* entry = leaf.data.data() + s.offset;
+                memcpy(&key, entry, 4);
+                row = entry + 4;
+                len = static_cast<uint16_t>(s.length - 4);
+                return true;
+            }
+            // next leaf of the chain
+            if (leaf.link == 0 || !tree->readNode(leaf.link, leaf) || leaf.kind != PAGE_KIND_BTREE_LEAF) done = true;
+            slot = 0;
+        }
+        return false;
+    }
+
+    // ---------- insert ----------
+
+    bool BPlusTree::insert(int key, const vector<uint8_t>& row) {
+        if (row.size() > MAX_ROW_BYTES) return false;
+        vector<Step> steps;
+        Page leaf;
+        if (!descend(key, steps, leaf)) return false;
+
+        uint16_t pos = lowerBound(leaf, key);
+        bool replacing = pos < leaf.slots.size() && keyAt(leaf, pos) == key;
+        if (replacing) removeAt(leaf, pos);
+        else rows++;
+
+        Entry entry = makeEntry(key, row.data(), row.size());
+        if (insertAt(leaf, pos, entry)) return writeNode(leaf) && writeMeta();
+
+        // split: the upper half moves to a new right sibling
+        vector<Entry> all = entries(leaf);
+        all.insert(all.begin() + pos, entry);
+        // appending past the end of the last leaf (ascending ids): keep the left leaf full
+        bool append = pos == leaf.slots.size() && leaf.link == 0;
+        size_t m = append ? all.size() - 1 : balancedSplit(all, false);
+
+        Page right;
+        right.pageID = allocate();
+        right.kind = PAGE_KIND_BTREE_LEAF;
+        right.rowFormat = leaf.rowFormat;
+        right.link = leaf.link;
+        fill(leaf, all.begin(), all.begin() + m);
+        fill(right, all.begin() + m, all.end());
+        leaf.link = right.pageID;
+        if (!writeNode(leaf) || !writeNode(right)) return false;
+        return insertIntoParent(steps, keyAt(right, 0), right.pageID) && writeMeta();
+    }
+
+    // Adds the separator for a new right sibling to the parent at the end of steps,
+    // splitting upwards while nodes are full; a split root gets a new root above it
+    bool BPlusTree::insertIntoParent(vector<Step>& steps, int key, uint32_t child) {
+        Entry entry = makeEntry(key, &child, 4);
+        if (steps.empty()) {
+            Page top;
+            top.pageID = allocate();
+            top.kind = PAGE_KIND_BTREE_INTERNAL;
+            top.link = root;
+            insertAt(top, 0, entry);
+            root = top.pageID;
+            return writeNode(top);
+        }
+
+        Step step = steps.back();
+        steps.pop_back();
+        Page node;
+        if (!readNode(step.page, node)) return false;
+        // the new child sits right after the one that split
+        uint16_t pos = step.child;
+        if (insertAt(node, pos, entry)) return writeNode(node);
+
+        vector<Entry> all = entries(node);
+        all.insert(all.begin() + pos, entry);
+        size_t m = balancedSplit(all, true);
+        int upKey = 0;
+        uint32_t upChild = 0;
+        memcpy(&upKey, all[m].data(), 4);
+        memcpy(&upChild, all[m].data() + 4, 4);
+
+        Page right;
+        right.pageID = allocate();
+        right.kind = PAGE_KIND_BTREE_INTERNAL;
+        right.link = upChild;
+        fill(node, all.begin(), all.begin() + m);
+        fill(right, all.begin() + m + 1, all.end());
+        if (!writeNode(node) || !writeNode(right)) return false;
+        return insertIntoParent(steps, upKey, right.pageID);
+    }
+
+    // ---------- delete ----------
+
+    bool BPlusTree::erase(int key) {
+        vector<Step> steps;
+        Page leaf;
+        if (!descend(key, steps, leaf)) return false;
+        uint16_t pos = lowerBound(leaf, key);
+        if (pos >= leaf.slots.size() || keyAt(leaf, pos) != key) return false;
+
+        removeAt(leaf, pos);
+        rows--;
+        if (steps.empty() || usedBytes(leaf) >= MIN_FILL) return writeNode(leaf) && writeMeta();
+        return rebalance(leaf, steps) && writeMeta();
+    }
+
+    // node (not yet written) fell below MIN_FILL: merge it with a sibling under the same
+    // parent if both fit in one page, otherwise even out the entries of the two.
+    // A merge removes a separator from the parent, which may underflow in turn.
+    bool BPlusTree::rebalance(Page& node, vector<Step>& steps) {
+        Step step = steps.back();
+        steps.pop_back();
+        Page parent;
+        if (!readNode(step.page, parent) || parent.slots.empty()) return false;
+        bool leaf = node.kind == PAGE_KIND_BTREE_LEAF;
+
+        // the left sibling if there is one, so a merge always folds right into left
+        uint16_t sep = step.child > 0 ? static_cast<uint16_t>(step.child - 1) : 0;
+        Page left, right;
+        if (step.child > 0) {
+            if (!readNode(childAt(parent, sep), left)) return false;
+            right = move(node);
+        } else {
+            left = move(node);
+            if (!readNode(childAt(parent, 1), right)) return false;
+        }
+
+        vector<Entry> all = entries(left);
+        // internal nodes: the separator comes down over the right node's leftmost child
+        if (!leaf) all.push_back(makeEntry(keyAt(parent, sep), &right.link, 4));
+        vector<Entry> moved = entries(right);
+        all.insert(all.end(), moved.begin(), moved.end());
+
+        if (fitBytes(all.begin(), all.end()) <= NODE_BYTES) {
+            fill(left, all.begin(), all.end());
+            if (leaf) left.link = right.link;
+            if (!writeNode(left)) return false;
+            release(right.pageID);
+            removeAt(parent, sep);
+            if (steps.empty()) {
+                // root left with a single child: that child becomes the root
+                if (!parent.slots.empty()) return writeNode(parent);
+                root = parent.link;
+                release(parent.pageID);
+                return true;
+            }
+            if (usedBytes(parent) >= MIN_FILL) return writeNode(parent);
+            return rebalance(parent, steps);
+        }
+
+        // borrow: split the combined entries evenly and move the separator
+        size_t m = balancedSplit(all, !leaf);
+        int separator = 0;
+        if (leaf) {
+            fill(left, all.begin(), all.begin() + m);
+            fill(right, all.begin() + m, all.end());
+            separator = keyAt(right, 0);
+        } else {
+            memcpy(&separator, all[m].data(), 4);
+            memcpy(&right.link, all[m].data() + 4, 4);
+            fill(left, all.begin(), all.begin() + m);
+            fill(right, all.begin() + m + 1, all.end());
+        }
+        removeAt(parent, sep);
+        insertAt(parent, sep, makeEntry(separator, &right.pageID, 4));
+        return writeNode(left) && writeNode(right) && writeNode(parent);
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,106 @@
+#ifndef CHRONODB_BTREE_H
+#define CHRONODB_BTREE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include "page.h"
+#include "buffer_pool.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Disk-resident B+Tree of a BTREE table, keyed by the INT primary key, one node per 8 KB page.
+    //
+    // File layout (<table>.btree), kinds as in page.h:
+    //   page 0   : META, one record: "CBPT" | version:u8 | pad:3 | root:u32 | pageCount:u32 | freeHead:u32 | rows:u64
+    //   leaf     : LEAF, link = next leaf (0: last); one slot per row, in key order: key:i32 | row bytes
+    //   internal : INTERNAL, link = leftmost child; slots in key order: key:i32 | child:u32
+    //              (a child holds the keys >= its key and below the next one)
+    //   free     : FREE, link = next free page
+    //
+    // Nodes are read and written through the buffer pool like HEAP pages, so they reach
+    // disk only at checkpoints and the write-ahead log redoes anything newer. A node splits
+    // when an entry does not fit; one that falls below a quarter full after a delete is
+    // merged with a sibling, or borrows from it when both do not fit in one page.
+    class BPlusTree {
+    public:
+        // Largest row a leaf accepts, so a node always splits into two that fit
+        static constexpr size_t MAX_ROW_BYTES = (PAGE_SIZE - PAGE_HEADER_RESERVED) / 4 - 4 - sizeof(SlotEntry);
+
+        BPlusTree() = default;
+        BPlusTree(BufferPool& bufferPool, const string& filePath) : pool(&bufferPool), path(filePath) {}
+
+        bool create(); // new file: meta page + empty root leaf, written straight to disk
+        bool open();   // reads the meta page
+
+        bool find(int key, vector<uint8_t>& row) const;
+        bool insert(int key, const vector<uint8_t>& row); // replaces the row of an existing key
+        bool erase(int key);
+
+        uint64_t size() const { return rows; }
+        uint32_t height() const;
+        uint32_t pageCount() const { return pages; }
+
+        // Rows in key order from the first key >= from. A row stays valid until the next call.
+        class Iterator {
+        public:
+            bool next(int& key, const uint8_t*& row, uint16_t& len);
+        private:
+            friend class BPlusTree;
+            const BPlusTree* tree = nullptr;
+            Page leaf;
+            uint16_t slot = 0;
+            bool done = true;
+        };
+        Iterator seek(int from = INT_MIN) const;
+
+    private:
+        static constexpr uint8_t VERSION = 1;
+        static constexpr size_t NODE_BYTES = PAGE_SIZE - PAGE_HEADER_RESERVED; // data area + slot directory
+        static constexpr size_t MIN_FILL = NODE_BYTES / 4;
+
+        BufferPool* pool = nullptr;
+        string path;
+        uint32_t root = 1;
+        uint32_t pages = 2;
+        uint32_t freeHead = 0;
+        uint64_t rows = 0;
+
+        // descent path: node page and the child index taken in it (0: leftmost child)
+        struct Step {
+            uint32_t page;
+            uint16_t child;
+        };
+        using Entry = vector<uint8_t>;
+
+        bool readNode(uint32_t pageID, Page& out) const;
+        bool writeNode(const Page& node);
+        Page metaPage() const;
+        bool writeMeta();
+        uint32_t allocate();
+        void release(uint32_t pageID);
+        bool descend(int key, vector<Step>& steps, Page& leaf) const;
+
+        bool insertIntoParent(vector<Step>& steps, int key, uint32_t child);
+        bool rebalance(Page& node, vector<Step>& steps);
+
+        // node helpers
+        static int keyAt(const Page& node, uint16_t i);
+        static uint32_t childAt(const Page& node, uint16_t i); // 0: link, i: slot i - 1
+        static uint16_t lowerBound(const Page& node, int key);
+        static uint16_t childIndexFor(const Page& node, int key);
+        static size_t usedBytes(const Page& node);
+        static bool insertAt(Page& node, uint16_t pos, const Entry& entry);
+        static void removeAt(Page& node, uint16_t pos);
+        static vector<Entry> entries(const Page& node);
+        static void fill(Page& node, vector<Entry>::const_iterator first, vector<Entry>::const_iterator last);
+        static size_t fitBytes(vector<Entry>::const_iterator first, vector<Entry>::const_iterator last);
+        static size_t balancedSplit(const vector<Entry>& all, bool dropMiddle);
+        static Entry makeEntry(int key, const void* payload, size_t bytes);
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_BTREE_H
@@ -0,0 +1,303 @@
+// buffer_pool.cpp
+#include "buffer_pool.h"
+#include "file_io.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
+using namespace std;
+
+namespace ChronoDB {
+
+    BufferPool::BufferPool(size_t budgetBytes) {
+        capacity = max<size_t>(budgetBytes / PAGE_SIZE, 1);
+    }
+
+    BufferPool::~BufferPool() {
+        flushAll();
+    }
+
+    void BufferPool::readFromDisk(const PageKey& key, Page& out) {
+        vector<uint8_t> buffer(PAGE_SIZE, 0);
+        ifstream in(key.file, ios::binary);
+        if (in) {
+            in.seekg(static_cast<streampos>(key.pageIndex) * PAGE_SIZE);
+            in.read(reinterpret_cast<char*>(buffer.data()), PAGE_SIZE);
+        }
+        out = Page();
+        out.deserializeFromBuffer(buffer);
+    }
+
+    bool BufferPool::writeFrame(BufferFrame& frame) {
+        if (!frame.dirty) return true;
+        if (beforeWrite) beforeWrite();
+
+        fstream out(frame.key.file, ios::binary | ios::in | ios::out);
+        if (!out) {
+            out.open(frame.key.file, ios::binary | ios::out);
+            out.close();
+            out.open(frame.key.file, ios::binary | ios::in | ios::out);
+        }
+        if (!out) return false;
+
+        vector<uint8_t> buffer;
+        frame.page.serializeToBuffer(buffer);
+        out.seekp(static_cast<streampos>(frame.key.pageIndex) * PAGE_SIZE);
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        out.close();
+
+        frame.dirty = false;
+        dirtyFrames--;
+        writes++;
+        return true;
+    }
+
+    void BufferPool::releaseFrame(size_t index) {
+        BufferFrame& f = *frames[index];
+        pageTable.erase(f.key);
+        if (f.dirty) dirtyFrames--;
+        f.inUse = false;
+        f.dirty = false;
+        f.referenced = false;
+        f.pinCount = 0;
+        freeFrames.push_back(index);
+    }
+
+    // CLOCK: sweep the frames, giving referenced ones a second chance
+    long BufferPool::findVictim() {
+        // free frame first (also grows the pool lazily up to its capacity)
+        while (!freeFrames.empty()) {
+            size_t i = freeFrames.back();
+            freeFrames.pop_back();
+            if (i < frames.size() && !frames[i]->inUse) return static_cast<long>(i);
+        }
+        if (frames.size() < capacity) {
+            frames.push_back(make_unique<BufferFrame>());
+            return static_cast<long>(frames.size() - 1);
+        }
+
+        for (size_t sweep = 0; sweep < 2 * frames.size(); ++sweep) {
+            size_t i = clockHand;
+            clockHand = (clockHand + 1) % frames.size();
+
+            BufferFrame& f = *frames[i];
+            if (f.pinCount > 0) continue;
+            if (f.dirty && noSteal) continue;
+            if (f.referenced) { f.referenced = false; continue; }
+
+            if (!writeFrame(f)) continue;
+            releaseFrame(i);
+            freeFrames.pop_back();
+            evictions++;
+            return static_cast<long>(i);
+        }
+
+        // no-steal: every unpinned frame is dirty, overflow until the next checkpoint
+        if (noSteal) {
+            frames.push_back(make_unique<BufferFrame>());
+            return static_cast<long>(frames.size() - 1);
+        }
+        return -1; // everything pinned
+    }
+
+    Page* BufferPool::pinPage(const string& file, uint32_t pageIndex, bool loadFromDisk) {
+        PageKey key{file, pageIndex};
+        auto it = pageTable.find(key);
+        if (it != pageTable.end()) {
+            BufferFrame& f = *frames[it->second];
+            f.pinCount++;
+            f.referenced = true;
+            hits++;
+            return &f.page;
+        }
+
+        misses++;
+        long victim = findVictim();
+        if (victim < 0) return nullptr;
+
+        BufferFrame& f = *frames[victim];
+        f.key = key;
+        f.inUse = true;
+        f.dirty = false;
+        f.referenced = true;
+        f.pinCount = 1;
+        if (loadFromDisk) readFromDisk(key, f.page);
+        else f.page = Page();
+        pageTable[key] = static_cast<size_t>(victim);
+        return &f.page;
+    }
+
+    void BufferPool::unpinPage(const string& file, uint32_t pageIndex, bool dirty) {
+        auto it = pageTable.find(PageKey{file, pageIndex});
+        if (it == pageTable.end()) return;
+        BufferFrame& f = *frames[it->second];
+        if (f.pinCount > 0) f.pinCount--;
+        if (dirty && !f.dirty) {
+            f.dirty = true;
+            dirtyFrames++;
+        }
+    }
+
+    bool BufferPool::flushPage(const string& file, uint32_t pageIndex) {
+        auto it = pageTable.find(PageKey{file, pageIndex});
+        if (it == pageTable.end()) return true;
+        return writeFrame(*frames[it->second]);
+    }
+
+    void BufferPool::flushFile(const string& file) {
+        for (auto& f : frames)
+            if (f->inUse && f->key.file == file) writeFrame(*f);
+    }
+
+    void BufferPool::flushAll() {
+        for (auto& f : frames)
+            if (f->inUse) writeFrame(*f);
+        trimOverflow();
+    }
+
+    bool BufferPool::hasDirtyPages(const string& file) const {
+        if (dirtyFrames == 0) return false;
+        for (const auto& f : frames)
+            if (f->inUse && f->dirty && f->key.file == file) return true;
+        return false;
+    }
+
+    // double-write file: "CDWB" | version:u8 | pad:3 | tag:u64 | count:u32
+    //                    | count x (pathLength:u16 | path | pageIndex:u32 | page bytes) | crc32:u32
+    bool BufferPool::flushAllAtomic(const string& doubleWriteFile, uint64_t tag) {
+        if (dirtyFrames == 0) {
+            trimOverflow();
+            return true;
+        }
+        if (beforeWrite) beforeWrite();
+
+        vector<uint8_t> out = {'C', 'D', 'W', 'B', 1, 0, 0, 0};
+        out.resize(20);
+        memcpy(out.data() + 8, &tag, 8);
+        uint32_t count = 0;
+        vector<uint8_t> page;
+        for (auto& f : frames) {
+            if (!f->inUse || !f->dirty) continue;
+            uint16_t pathLength = static_cast<uint16_t>(f->key.file.size());
+            size_t pos = out.size();
+            out.resize(pos + 2 + pathLength + 4);
+            memcpy(out.data() + pos, &pathLength, 2);
+            memcpy(out.data() + pos + 2, f->key.file.data(), pathLength);
+            memcpy(out.data() + pos + 2 + pathLength, &f->key.pageIndex, 4);
+            f->page.serializeToBuffer(page);
+            out.insert(out.end(), page.begin(), page.end());
+            count++;
+        }
+        memcpy(out.data() + 16, &count, 4);
+        uint32_t crc = crc32(out.data(), out.size());
+        out.resize(out.size() + 4);
+        memcpy(out.data() + out.size() - 4, &crc, 4);
+
+        DurableFile dw;
+        if (!dw.open(doubleWriteFile, true) || !dw.append(out.data(), out.size()) || !dw.sync()) return false;
+        dw.close();
+
+        // now the in-place writes may tear: the double-write copy repairs them on restart
+        unordered_set<string> touched;
+        for (auto& f : frames) {
+            if (!f->inUse || !f->dirty) continue;
+            touched.insert(f->key.file);
+            if (!writeFrame(*f)) return false;
+        }
+        for (const string& file : touched)
+            if (!syncFile(file)) return false;
+
+        trimOverflow();
+        return true;
+    }
+
+    optional<uint64_t> BufferPool::recoverDoubleWrite(const string& doubleWriteFile) {
+        vector<uint8_t> in;
+        {
+            ifstream f(doubleWriteFile, ios::binary | ios::ate);
+            if (!f) return nullopt;
+            in.resize(static_cast<size_t>(f.tellg()));
+            f.seekg(0);
+            f.read(reinterpret_cast<char*>(in.data()), in.size());
+        }
+        // incomplete batch: the crash hit before any in-place write, the files are intact
+        if (in.size() < 24 || memcmp(in.data(), "CDWB", 4) != 0 || in[4] != 1) return nullopt;
+        uint32_t crc = 0;
+        memcpy(&crc, in.data() + in.size() - 4, 4);
+        if (crc32(in.data(), in.size() - 4) != crc) return nullopt;
+
+        uint64_t tag = 0;
+        uint32_t count = 0;
+        memcpy(&tag, in.data() + 8, 8);
+        memcpy(&count, in.data() + 16, 4);
+
+        unordered_set<string> touched;
+        size_t pos = 20;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint16_t pathLength = 0;
+            memcpy(&pathLength, in.data() + pos, 2);
+            string file(reinterpret_cast<const char*>(in.data() + pos + 2), pathLength);
+            uint32_t pageIndex = 0;
+            memcpy(&pageIndex, in.data() + pos + 2 + pathLength, 4);
+            pos += 2 + pathLength + 4;
+
+            fstream out(file, ios::binary | ios::in | ios::out);
+            if (!out) out.open(file, ios::binary | ios::out);
+            out.seekp(static_cast<streampos>(pageIndex) * PAGE_SIZE);
+            out.write(reinterpret_cast<const char*>(in.data() + pos), PAGE_SIZE);
+            pos += PAGE_SIZE;
+            touched.insert(file);
+        }
+        for (const string& file : touched) syncFile(file);
+        return tag;
+    }
+
+    // Drops frames past the budget once they are clean again (after no-steal overflow)
+    void BufferPool::trimOverflow() {
+        while (frames.size() > capacity) {
+            size_t last = frames.size() - 1;
+            BufferFrame& f = *frames[last];
+            if (f.inUse && (f.pinCount > 0 || f.dirty)) break;
+            if (f.inUse) {
+                releaseFrame(last);
+                evictions++;
+            }
+            frames.pop_back();
+        }
+        if (clockHand >= frames.size()) clockHand = 0;
+    }
+
+    void BufferPool::discardFile(const string& file) {
+        for (size_t i = 0; i < frames.size(); ++i)
+            if (frames[i]->inUse && frames[i]->key.file == file) releaseFrame(i);
+    }
+
+    void BufferPool::discardFrom(const string& file, uint32_t pageIndex) {
+        for (size_t i = 0; i < frames.size(); ++i) {
+            const BufferFrame& f = *frames[i];
+            if (f.inUse && f.key.file == file && f.key.pageIndex >= pageIndex) releaseFrame(i);
+        }
+    }
+
+    void BufferPool::setBudget(size_t budgetBytes) {
+        capacity = max<size_t>(budgetBytes / PAGE_SIZE, 1);
+        // shrink: write back (unless no-steal) and drop unpinned frames past the new capacity;
+        // dirty no-steal frames stay as overflow until the next checkpoint
+        if (!noSteal) {
+            for (size_t i = capacity; i < frames.size(); ++i)
+                if (frames[i]->inUse && frames[i]->pinCount == 0) writeFrame(*frames[i]);
+        }
+        trimOverflow();
+        clockHand = 0;
+    }
+
+    double BufferPool::hitRatio() const {
+        uint64_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+
+    void BufferPool::resetStats() {
+        hits = misses = evictions = writes = 0;
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,122 @@
+#ifndef CHRONODB_BUFFER_POOL_H
+#define CHRONODB_BUFFER_POOL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include "page.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    static constexpr size_t DEFAULT_BUFFER_POOL_BYTES = 8 * 1024 * 1024; // 1024 frames of 8 KB
+
+    // A page is identified by the file it lives in and its index in that file
+    struct PageKey {
+        string file;
+        uint32_t pageIndex = 0;
+
+        bool operator==(const PageKey& other) const {
+            return pageIndex == other.pageIndex && file == other.file;
+        }
+    };
+
+    struct PageKeyHash {
+        size_t operator()(const PageKey& k) const {
+            return hash<string>()(k.file) ^ (static_cast<size_t>(k.pageIndex) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    struct BufferFrame {
+        PageKey key;
+        Page page;
+        int pinCount = 0;
+        bool dirty = false;
+        bool referenced = false; // CLOCK reference bit
+        bool inUse = false;
+    };
+
+    // Fixed-size cache of Page frames shared by every table file.
+    // Pages are pinned while in use, written back lazily when dirty,
+    // and evicted with the CLOCK (second chance) policy.
+    //
+    // In no-steal mode (used with the write-ahead log) dirty frames are never evicted:
+    // they reach disk only through flushAllAtomic() at a checkpoint. If every frame is
+    // dirty the pool grows past its budget until the next checkpoint trims it.
+    class BufferPool {
+    public:
+        explicit BufferPool(size_t budgetBytes = DEFAULT_BUFFER_POOL_BYTES);
+        ~BufferPool();
+
+        // Returns the pinned frame's page (loaded from disk on a miss), or nullptr if every frame is pinned.
+        // When loadFromDisk is false the frame starts as an empty page (caller overwrites it completely).
+        Page* pinPage(const string& file, uint32_t pageIndex, bool loadFromDisk = true);
+        void unpinPage(const string& file, uint32_t pageIndex, bool dirty);
+
+        bool flushPage(const string& file, uint32_t pageIndex);
+        void flushFile(const string& file);
+        void flushAll();
+
+        // Checkpoint write: every dirty frame is first written (with the tag) to a double-write
+        // file and fsync'd, then written in place and fsync'd. The caller removes the
+        // double-write file once the checkpoint is complete.
+        bool flushAllAtomic(const string& doubleWriteFile, uint64_t tag);
+        // Startup: if a complete double-write file exists, rewrites its pages in place
+        // (repairing torn writes) and returns its tag
+        static optional<uint64_t> recoverDoubleWrite(const string& doubleWriteFile);
+
+        void setNoSteal(bool enabled) { noSteal = enabled; }
+        size_t dirtyCount() const { return dirtyFrames; }
+        bool hasDirtyPages(const string& file) const;
+
+        // Drops every frame of a file without writing it (file was rewritten or removed)
+        void discardFile(const string& file);
+        // Drops frames at or beyond pageIndex (file was truncated)
+        void discardFrom(const string& file, uint32_t pageIndex);
+
+        // Memory budget in bytes; shrinking flushes and evicts unpinned frames
+        void setBudget(size_t budgetBytes);
+        size_t budget() const { return capacity * PAGE_SIZE; }
+        size_t frameCount() const { return capacity; }
+        size_t overflowCount() const { return frames.size() > capacity ? frames.size() - capacity : 0; }
+
+        // Called before a dirty frame is written to disk (e.g. to force a log first)
+        void setBeforeWriteHook(function<void()> hook) { beforeWrite = move(hook); }
+
+        // Statistics (for sizing the pool)
+        uint64_t hitCount() const { return hits; }
+        uint64_t missCount() const { return misses; }
+        uint64_t evictionCount() const { return evictions; }
+        uint64_t writeCount() const { return writes; }
+        double hitRatio() const;
+        void resetStats();
+
+    private:
+        size_t capacity;
+        vector<unique_ptr<BufferFrame>> frames; // grows lazily up to capacity
+        vector<size_t> freeFrames;
+        unordered_map<PageKey, size_t, PageKeyHash> pageTable;
+        size_t clockHand = 0;
+        function<void()> beforeWrite;
+        bool noSteal = false;
+        size_t dirtyFrames = 0;
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t writes = 0;
+
+        long findVictim();
+        bool writeFrame(BufferFrame& frame);
+        static void readFromDisk(const PageKey& key, Page& out);
+        void releaseFrame(size_t index);
+        void trimOverflow();
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_BUFFER_POOL_H
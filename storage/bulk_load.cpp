@@ -0,0 +1,612 @@
+// bulk_load.cpp
+// COPY <table> FROM '<file>': streams a CSV/TSV file in chunks and loads it without
+// going through the per-statement INSERT path.
+#include "storage.h"
+#include "csv_scan.h"
+#include "../utils/sorting.h"
+#include <filesystem>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <unordered_map>
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace ChronoDB {
+
+    static constexpr size_t BULK_CHUNK_BYTES = 1024 * 1024;
+    static constexpr size_t PARALLEL_CHUNK_BYTES = 4 * 1024 * 1024;
+    static constexpr size_t BULK_BATCH_PAGES = 64; // filled HEAP pages written together (512 KB)
+
+    static bool convertField(DataType type, const string& text, RecordValue& out) {
+        size_t b = text.find_first_not_of(' ');
+        size_t e = text.find_last_not_of(' ');
+        switch (type) {
+            case DataType::INT: {
+                if (b == string::npos) return false;
+                int v = 0;
+                auto [p, ec] = from_chars(text.data() + b, text.data() + e + 1, v);
+                if (ec != errc() || p != text.data() + e + 1) return false;
+                out = v;
+                return true;
+            }
+            case DataType::FLOAT: {
+                if (b == string::npos) return false;
+                char* p = nullptr;
+                errno = 0;
+                float v = strtof(text.c_str() + b, &p);
+                if (errno != 0 || p != text.c_str() + e + 1) return false;
+                out = v;
+                return true;
+            }
+            case DataType::STRING:
+                if (text.size() > UINT16_MAX) return false;
+                out = text;
+                return true;
+        }
+        return false;
+    }
+
+    // Converts fields[0..count) with the column types; false sets error
+    static bool convertRow(const vector<DataType>& types, const vector<string>& fields, size_t count,
+                           Record& out, string& error) {
+        if (count != types.size()) {
+            error = "expected " + to_string(types.size()) + " fields, got " + to_string(count);
+            return false;
+        }
+        out.fields.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!convertField(types[i], fields[i], out.fields[i])) {
+                error = "field " + to_string(i + 1) + " '" + fields[i] + "' is not " + DataTypeToString(types[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Splits the row at p into fields[0..count) and moves p past it; false at end of input.
+    // Same rules as CsvReader::readRow, but over a buffer that holds whole rows.
+    static bool parseRow(const char*& p, const char* end, char delim, CsvScan::Scanner& scan,
+                         vector<string>& fields, size_t& count, size_t& lines) {
+        count = 0;
+        if (p == end) return false;
+
+        while (true) {
+            if (count == fields.size()) fields.emplace_back();
+            string& field = fields[count++];
+            field.clear();
+
+            if (p < end && *p == '"') {
+                p++;
+                while (true) {
+                    const char* q = static_cast<const char*>(memchr(p, '"', end - p));
+                    if (!q) q = end;
+                    field.append(p, q);
+                    for (const char* n = p; (n = static_cast<const char*>(memchr(n, '\n', q - n))); ++n) lines++;
+                    if (q == end) { p = end; break; }
+                    p = q + 1;
+                    if (p == end || *p != '"') break;
+                    field += '"';
+                    p++;
+                }
+            }
+            while (true) {
+                const char* q = scan.next(p);
+                field.append(p, q);
+                p = q;
+                if (p == end || *p != '"') break;
+                field += '"'; // a quote inside an unquoted field is kept as is
+                p++;
+            }
+
+            if (p < end && *p == delim) {
+                p++;
+                continue;
+            }
+            if (p < end && *p == '\r') {
+                p++;
+                if (p < end && *p == '\n') p++;
+            } else if (p < end && *p == '\n') {
+                p++;
+            }
+            lines++;
+            return true;
+        }
+    }
+
+    // Row producer for bulkLoadHeap / bulkLoadStructure
+    class StorageEngine::RowSource {
+    public:
+        enum class Result { ROW, BAD_ROW, END };
+        virtual ~RowSource() = default;
+
+        // Next row converted into out; BAD_ROW sets error and skips the row
+        virtual Result next(Record& out, string& error) = 0;
+        virtual size_t lineNumber() const = 0; // line the last returned row starts on
+        virtual uint64_t bytesRead() const = 0;
+    };
+
+    // Reads one row at a time from a delimited file, refilling a fixed-size chunk buffer.
+    // Fields may be quoted ("a,b" with "" for a quote, newlines allowed inside quotes).
+    // Each row is converted with the table's column types.
+    class StorageEngine::CsvReader : public StorageEngine::RowSource {
+    public:
+        CsvReader(const string& path, char delimiter, const vector<DataType>& columnTypes)
+            : in(path, ios::binary), delim(delimiter), types(columnTypes), buffer(BULK_CHUNK_BYTES) {}
+
+        bool isOpen() const { return static_cast<bool>(in); }
+        uint64_t bytesRead() const override { return consumed; }
+        size_t lineNumber() const override { return rowLine; }
+
+        Result next(Record& out, string& error) override {
+            size_t count = 0;
+            do {
+                rowLine = line + 1;
+                if (!readRow(count)) return Result::END;
+            } while (count == 1 && fields[0].empty()); // blank line
+
+            return convertRow(types, fields, count, out, error) ? Result::ROW : Result::BAD_ROW;
+        }
+
+        // Skips the header line
+        void skipRow() {
+            size_t count = 0;
+            readRow(count);
+        }
+
+    private:
+        ifstream in;
+        char delim;
+        const vector<DataType>& types;
+        vector<char> buffer;
+        size_t pos = 0, end = 0;
+        uint64_t consumed = 0;
+        size_t line = 0, rowLine = 0;
+        vector<string> fields; // reused between rows (keeps their capacity)
+
+        int get() {
+            if (pos == end && !refill()) return EOF;
+            return static_cast<unsigned char>(buffer[pos++]);
+        }
+
+        int peek() {
+            if (pos == end && !refill()) return EOF;
+            return static_cast<unsigned char>(buffer[pos]);
+        }
+
+        bool refill() {
+            if (!in) return false;
+            in.read(buffer.data(), buffer.size());
+            end = static_cast<size_t>(in.gcount());
+            pos = 0;
+            consumed += end;
+            return end > 0;
+        }
+
+        // Splits the next line into fields[0..count); false at end of input
+        bool readRow(size_t& count) {
+            count = 0;
+            int c = get();
+            if (c == EOF) return false;
+
+            while (true) {
+                if (count == fields.size()) fields.emplace_back();
+                string& field = fields[count++];
+                field.clear();
+
+                if (c == '"') {
+                    while ((c = get()) != EOF) {
+                        if (c == '"') {
+                            if (peek() != '"') { c = get(); break; }
+                            get();
+                        } else if (c == '\n') {
+                            line++;
+                        }
+                        field += static_cast<char>(c);
+                    }
+                }
+                while (c != delim && c != '\n' && c != '\r' && c != EOF) {
+                    field += static_cast<char>(c);
+                    c = get();
+                }
+
+                if (c == delim) {
+                    c = get();
+                    continue;
+                }
+                if (c == '\r' && peek() == '\n') get();
+                line++;
+                return true;
+            }
+        }
+    };
+
+    // COPY ... PARALLEL: a reader thread cuts the file into PARALLEL_CHUNK_BYTES chunks
+    // that end on a row boundary (CsvScan::rowAlignedLength), a pool of workers parses
+    // chunks into Records, and next() hands them to the single writer in file order.
+    // At most 2 chunks per worker are in flight, which bounds memory on large files.
+    class StorageEngine::ParallelCsvReader : public StorageEngine::RowSource {
+    public:
+        ParallelCsvReader(const string& path, char delimiter, const vector<DataType>& columnTypes,
+                          bool skipHeader, unsigned threads)
+            : in(path, ios::binary), opened(static_cast<bool>(in)), delim(delimiter), types(columnTypes),
+              header(skipHeader), maxInFlight(2 * static_cast<size_t>(threads)) {
+            if (!opened) return;
+            reader = thread(&ParallelCsvReader::readLoop, this);
+            for (unsigned i = 0; i < threads; ++i) workers.emplace_back(&ParallelCsvReader::workLoop, this);
+        }
+
+        ~ParallelCsvReader() override {
+            {
+                lock_guard<mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            if (reader.joinable()) reader.join();
+            for (auto& w : workers) w.join();
+        }
+
+        bool isOpen() const { return opened; }
+        uint64_t bytesRead() const override { return consumed.load(); }
+        size_t lineNumber() const override { return rowLine; }
+
+        Result next(Record& out, string& error) override {
+            while (true) {
+                if (haveCurrent) {
+                    if (errorPos < current.errors.size()) {
+                        rowLine = baseLine + current.errors[errorPos].first;
+                        error = move(current.errors[errorPos++].second);
+                        return Result::BAD_ROW;
+                    }
+                    if (rowPos < current.rows.size()) {
+                        rowLine = baseLine + current.rowLines[rowPos];
+                        out = move(current.rows[rowPos++]);
+                        return Result::ROW;
+                    }
+                    baseLine += current.lines;
+                    haveCurrent = false;
+                }
+
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&] { return done.count(nextSeq) > 0 || (eof && nextSeq == produced); });
+                auto it = done.find(nextSeq);
+                if (it == done.end()) return Result::END;
+                current = move(it->second);
+                done.erase(it);
+                nextSeq++;
+                lock.unlock();
+                cv.notify_all(); // room for another chunk
+
+                haveCurrent = true;
+                rowPos = errorPos = 0;
+            }
+        }
+
+    private:
+        struct Chunk {
+            size_t seq = 0;
+            string data;
+        };
+        struct ParsedChunk {
+            vector<Record> rows;
+            vector<size_t> rowLines;              // chunk-relative line of each row
+            vector<pair<size_t, string>> errors;  // chunk-relative line, message
+            size_t lines = 0;
+        };
+
+        ifstream in; // read by the reader thread only
+        bool opened;
+        char delim;
+        const vector<DataType>& types;
+        bool header;
+        size_t maxInFlight;
+        atomic<uint64_t> consumed{0};
+
+        mutex m;
+        condition_variable cv;
+        deque<Chunk> pending;          // read, waiting for a worker
+        map<size_t, ParsedChunk> done; // parsed, waiting for the writer
+        size_t produced = 0;           // chunks read so far
+        size_t nextSeq = 0;            // next chunk the writer takes
+        bool eof = false, stopping = false;
+        thread reader;
+        vector<thread> workers;
+
+        // writer side (only touched by next())
+        ParsedChunk current;
+        bool haveCurrent = false;
+        size_t rowPos = 0, errorPos = 0;
+        size_t baseLine = 0, rowLine = 0;
+
+        void readLoop() {
+            vector<char> block(PARALLEL_CHUNK_BYTES);
+            string carry; // start of a row that did not fit in the last chunk
+            bool last = false;
+            while (!last) {
+                in.read(block.data(), block.size());
+                size_t got = static_cast<size_t>(in.gcount());
+                consumed += got;
+                last = !in;
+                carry.append(block.data(), got);
+
+                size_t cut = last ? carry.size() : CsvScan::rowAlignedLength(carry.data(), carry.size());
+                if (cut == 0) continue; // one row longer than a chunk: keep reading
+
+                Chunk chunk;
+                chunk.data.assign(carry, 0, cut);
+                carry.erase(0, cut);
+
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&] { return stopping || produced - nextSeq < maxInFlight; });
+                if (stopping) return;
+                chunk.seq = produced++;
+                pending.push_back(move(chunk));
+                lock.unlock();
+                cv.notify_all();
+            }
+            {
+                lock_guard<mutex> lock(m);
+                eof = true;
+            }
+            cv.notify_all();
+        }
+
+        void workLoop() {
+            while (true) {
+                Chunk chunk;
+                {
+                    unique_lock<mutex> lock(m);
+                    cv.wait(lock, [&] { return stopping || eof || !pending.empty(); });
+                    if (stopping || pending.empty()) return;
+                    chunk = move(pending.front());
+                    pending.pop_front();
+                }
+                ParsedChunk parsed = parse(chunk);
+                {
+                    lock_guard<mutex> lock(m);
+                    done.emplace(chunk.seq, move(parsed));
+                }
+                cv.notify_all();
+            }
+        }
+
+        ParsedChunk parse(const Chunk& chunk) const {
+            ParsedChunk result;
+            vector<string> fields;
+            const char* p = chunk.data.data();
+            const char* end = p + chunk.data.size();
+            size_t count = 0;
+            CsvScan::Scanner scan(end, delim);
+            if (header && chunk.seq == 0) parseRow(p, end, delim, scan, fields, count, result.lines);
+
+            Record rec;
+            string error;
+            while (true) {
+                size_t line = result.lines + 1;
+                if (!parseRow(p, end, delim, scan, fields, count, result.lines)) break;
+                if (count == 1 && fields[0].empty()) continue; // blank line
+                if (convertRow(types, fields, count, rec, error)) {
+                    result.rows.push_back(move(rec));
+                    result.rowLines.push_back(line);
+                } else {
+                    result.errors.emplace_back(line, move(error));
+                }
+            }
+            return result;
+        }
+    };
+
+    optional<BulkLoadStats> StorageEngine::bulkLoad(const string& tableName, const string& filePath, const BulkLoadOptions& options) {
+        const CatalogEntry* table = findTable(tableName);
+        if (!table || table->types.empty() || table->types[0] != DataType::INT) return nullopt;
+
+        char delimiter = options.delimiter;
+        if (delimiter == 0) delimiter = (fs::path(filePath).extension() == ".tsv") ? '\t' : ',';
+        unsigned threads = options.threads != 0 ? options.threads : max(1u, thread::hardware_concurrency());
+
+        auto start = chrono::steady_clock::now();
+        unique_ptr<RowSource> reader;
+        if (threads > 1) {
+            auto parallel = make_unique<ParallelCsvReader>(filePath, delimiter, table->types, options.header, threads);
+            if (!parallel->isOpen()) return nullopt;
+            reader = move(parallel);
+        } else {
+            auto serial = make_unique<CsvReader>(filePath, delimiter, table->types);
+            if (!serial->isOpen()) return nullopt;
+            if (options.header) serial->skipRow();
+            reader = move(serial);
+        }
+
+        BulkLoadStats stats;
+        if (getStructureType(tableName) == StructureType::HEAP) bulkLoadHeap(tableName, *reader, stats);
+        else bulkLoadStructure(tableName, *reader, stats);
+        checkpoint(); // the load is durable once its pages/snapshot are
+
+        stats.bytesRead = reader->bytesRead();
+        stats.threads = threads;
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    // Packs rows into fresh pages and appends each full page to the table file directly
+    // (not through the buffer pool). An existing row with the same id is replaced, as INSERT does.
+    void StorageEngine::bulkLoadHeap(const string& tableName, RowSource& reader, BulkLoadStats& stats) {
+        // start from a clean pool and an empty log: the pages written below are not logged
+        checkpoint();
+
+        string path = tableDataPath(tableName);
+        uint32_t next = pageCount(tableName);
+        if (next > 0) {
+            Page last;
+            readPageFromFile(tableName, next - 1, last);
+            if (last.slotCount == 0) next--; // reuse the empty page of a new table
+        }
+        bufferPool.discardFrom(path, next);
+
+        DurableFile out;
+        if (!out.open(path) || !out.truncate(static_cast<uint64_t>(next) * PAGE_SIZE)) return;
+
+        const CatalogEntry& table = *findTable(tableName);
+        PrimaryIndex& idx = indexFor(tableName);
+        FreeSpaceMap& fsm = freeSpaceFor(tableName);
+        ZoneMap& zones = zoneMapFor(tableName);
+        const RowLayout* layout = layoutFor(tableName, rowFormatOf(table));
+        Page page;
+        page.pageID = next;
+        page.rowFormat = rowFormatOf(table);
+        vector<uint8_t> bytes, buffer;
+        vector<Page> batch;                     // filled pages not written yet (ids batch[0].pageID...)
+        unordered_map<int, RecordID> unwritten; // rows of the batch and the current page, indexed once written
+        bool pendingDeletes = false;            // tombstones of replaced rows still only in the pool
+
+        auto writeBatch = [&]() {
+            // Replaced rows are tombstoned through the pool without a log record. They must
+            // reach the file before the pages holding their replacements, or a crash in
+            // between would leave both copies of an id on disk: one checkpoint per batch.
+            if (pendingDeletes) {
+                out.sync(); // the checkpoint's index points into the pages appended so far
+                checkpoint();
+                pendingDeletes = false;
+            }
+            for (const Page& full : batch) {
+                full.serializeToBuffer(buffer);
+                out.append(buffer.data(), buffer.size());
+                fsm.update(full.pageID, full.freeSpace() + full.deadBytes());
+                zones.update(full.pageID, full, layout);
+                stats.pagesWritten++;
+            }
+            for (auto it = unwritten.begin(); it != unwritten.end(); ) {
+                if (it->second.pageID == page.pageID) { ++it; continue; }
+                idx.put(it->first, it->second);
+                it = unwritten.erase(it);
+            }
+            batch.clear();
+        };
+
+        auto nextPage = [&]() {
+            uint32_t id = page.pageID + 1;
+            batch.push_back(move(page));
+            page = Page();
+            page.pageID = id;
+            page.rowFormat = rowFormatOf(table);
+            if (batch.size() >= BULK_BATCH_PAGES) writeBatch();
+        };
+
+        Record rec;
+        string error;
+        RowSource::Result result;
+        while ((result = reader.next(rec, error)) != RowSource::Result::END) {
+            if (result == RowSource::Result::BAD_ROW) {
+                if (stats.rowsRejected++ == 0) stats.firstError = "line " + to_string(reader.lineNumber()) + ": " + error;
+                continue;
+            }
+            int id = get<int>(rec.fields[0]);
+            encodeRow(table, rec, bytes); // rows were converted with the column types
+
+            // The new row is placed first: a row that fits nowhere leaves the earlier copy alone
+            auto slot = page.insertRawRecord(bytes);
+            if (!slot.has_value() && page.deadBytes() > 0) {
+                page.compact();
+                slot = page.insertRawRecord(bytes);
+            }
+            if (!slot.has_value() && page.liveSlotCount() > 0) {
+                nextPage();
+                slot = page.insertRawRecord(bytes);
+            }
+            if (!slot.has_value()) {
+                if (stats.rowsRejected++ == 0) stats.firstError = "line " + to_string(reader.lineNumber()) + ": row larger than a page";
+                continue;
+            }
+
+            // same id: earlier in this load (a page not written yet), or in the table / a written page
+            auto earlier = unwritten.find(id);
+            if (earlier != unwritten.end()) {
+                const RecordID& at = earlier->second;
+                Page& holder = (at.pageID == page.pageID) ? page : batch[at.pageID - batch.front().pageID];
+                holder.deleteSlot(at.slotID);
+            } else if (idx.find(id).has_value()) {
+                applyDelete(tableName, id);
+                pendingDeletes = true;
+            }
+            unwritten[id] = RecordID{page.pageID, slot.value()};
+            stats.rowsLoaded++;
+        }
+        if (page.slotCount > 0) nextPage();
+        writeBatch();
+        out.sync();
+    }
+
+    // AVL/BST: merges the sorted input with the existing rows and rebuilds the tree in O(N);
+    // HASH, COLUMNAR and BTREE: insert row by row. Duplicate ids follow INSERT (AVL keeps the last row).
+    void StorageEngine::bulkLoadStructure(const string& tableName, RowSource& reader, BulkLoadStats& stats) {
+        StructureType type = getStructureType(tableName);
+        vector<Record> rows;
+        bool sorted = true;
+        const CatalogEntry* table = findTable(tableName);
+        vector<uint8_t> bytes;
+
+        Record rec;
+        string error;
+        RowSource::Result result;
+        while ((result = reader.next(rec, error)) != RowSource::Result::END) {
+            if (result == RowSource::Result::BAD_ROW) {
+                if (stats.rowsRejected++ == 0) stats.firstError = "line " + to_string(reader.lineNumber()) + ": " + error;
+                continue;
+            }
+            if (type == StructureType::BTREE) {
+                if (!encodeRow(*table, rec, bytes) || !btreeFor(tableName).insert(get<int>(rec.fields[0]), bytes)) {
+                    if (stats.rowsRejected++ == 0) stats.firstError = "line " + to_string(reader.lineNumber()) + ": row too large for a B+Tree leaf";
+                    continue;
+                }
+                stats.rowsLoaded++;
+                // nodes are not logged either: write them out before they fill the (no-steal) pool
+                if (bufferPool.dirtyCount() * 4 >= bufferPool.frameCount() * 3) checkpoint();
+                continue;
+            }
+            stats.rowsLoaded++;
+            if (type == StructureType::HASH) {
+                hashTables[tableName].upsert(rec);
+                continue;
+            }
+            if (type == StructureType::COLUMNAR) {
+                columnStoreFor(tableName).append(rec);
+                continue;
+            }
+            if (!rows.empty() && get<int>(rec.fields[0]) < get<int>(rows.back().fields[0])) sorted = false;
+            rows.push_back(move(rec));
+        }
+        if (type == StructureType::BTREE) return; // pages, no snapshot
+        dirtySnapshots.insert(tableName);
+        if (type == StructureType::HASH || type == StructureType::COLUMNAR) return;
+
+        if (!sorted) Sorting::mergeSort(rows, 0, "INT"); // stable: file order kept for equal ids
+
+        vector<Record> existing = (type == StructureType::AVL) ? avlTables[tableName].getAllSorted()
+                                                                : bstTables[tableName].getAllSorted();
+        vector<Record> merged;
+        merged.reserve(existing.size() + rows.size());
+        size_t a = 0, b = 0;
+        while (a < existing.size() || b < rows.size()) {
+            bool takeExisting = b == rows.size() ||
+                (a < existing.size() && get<int>(existing[a].fields[0]) <= get<int>(rows[b].fields[0]));
+            Record& r = takeExisting ? existing[a++] : rows[b++];
+            if (type == StructureType::AVL && !merged.empty() && get<int>(merged.back().fields[0]) == get<int>(r.fields[0])) {
+                merged.back() = move(r); // AVL replaces the row of a duplicate id (later rows win)
+                continue;
+            }
+            merged.push_back(move(r));
+        }
+
+        if (type == StructureType::AVL) avlTables[tableName].buildFromSorted(merged);
+        else bstTables[tableName].buildFromSorted(merged);
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,587 @@
+// column_store.cpp
+#include "column_store.h"
+#include "file_io.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+using namespace std;
+
+namespace fs = std::filesystem;
+
+namespace ChronoDB {
+
+    // --- Chunk ---
+    size_t ColumnStore::Chunk::size() const {
+        switch (type) {
+            case DataType::INT: return ints.size();
+            case DataType::FLOAT: return floats.size();
+            default: return (encoding == Encoding::DICTIONARY) ? codes.size() : offsets.size();
+        }
+    }
+
+    void ColumnStore::Chunk::append(const RecordValue& v) {
+        switch (type) {
+            case DataType::INT: ints.push_back(get<int>(v)); break;
+            case DataType::FLOAT: floats.push_back(get<float>(v)); break;
+            default:
+                heap += get<string>(v);
+                offsets.push_back(static_cast<uint32_t>(heap.size()));
+                break;
+        }
+    }
+
+    string_view ColumnStore::Chunk::entry(size_t index) const {
+        uint32_t begin = (index == 0) ? 0 : offsets[index - 1];
+        return string_view(heap).substr(begin, offsets[index] - begin);
+    }
+
+    string_view ColumnStore::Chunk::stringAt(size_t row) const {
+        return entry((encoding == Encoding::DICTIONARY) ? codes[row] : row);
+    }
+
+    RecordValue ColumnStore::Chunk::value(size_t row) const {
+        switch (type) {
+            case DataType::INT: return ints[row];
+            case DataType::FLOAT: return floats[row];
+            default: return string(stringAt(row));
+        }
+    }
+
+    bool ColumnStore::Chunk::matches(size_t row, const ScanPredicate& where) const {
+        switch (type) {
+            case DataType::INT: return where.matchesInt(ints[row]);
+            case DataType::FLOAT: return where.matchesFloat(floats[row]);
+            default: return where.matchesString(stringAt(row));
+        }
+    }
+
+    void ColumnStore::Chunk::select(const ScanPredicate& where, vector<uint32_t>& selection) const {
+        uint32_t rows = static_cast<uint32_t>(size());
+        if (type != DataType::STRING || encoding != Encoding::DICTIONARY) {
+            for (uint32_t r = 0; r < rows; ++r)
+                if (matches(r, where)) selection.push_back(r);
+            return;
+        }
+
+        size_t entries = offsets.size();
+        if (where.op == CompareOp::EQ) {
+            // entries are sorted: one binary search, then compare codes
+            if (!holds_alternative<string>(where.value)) return;
+            string_view target = get<string>(where.value);
+            size_t lo = 0, hi = entries;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (entry(mid) < target) lo = mid + 1;
+                else hi = mid;
+            }
+            if (lo == entries || entry(lo) != target) return;
+            uint16_t code = static_cast<uint16_t>(lo);
+            for (uint32_t r = 0; r < rows; ++r)
+                if (codes[r] == code) selection.push_back(r);
+            return;
+        }
+
+        vector<uint8_t> hit(entries);
+        for (size_t e = 0; e < entries; ++e) hit[e] = where.matchesString(entry(e));
+        for (uint32_t r = 0; r < rows; ++r)
+            if (hit[codes[r]]) selection.push_back(r);
+    }
+
+    namespace {
+        void put(vector<uint8_t>& out, const void* data, size_t bytes) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), p, p + bytes);
+        }
+
+        uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+        int64_t unzigzag(uint64_t z) { return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1); }
+
+        size_t varintBytes(uint64_t v) {
+            size_t n = 1;
+            while (v >= 0x80) { v >>= 7; n++; }
+            return n;
+        }
+
+        void putVarint(vector<uint8_t>& out, uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(v));
+        }
+
+        bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+            v = 0;
+            for (int shift = 0; p < end && shift < 64; shift += 7) {
+                uint8_t b = *p++;
+                v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) return true;
+            }
+            return false;
+        }
+    }
+
+    // Sorted distinct values + one code per row; false (nothing written) if that is not
+    // smaller than the plain chunk
+    bool ColumnStore::Chunk::encodeDictionary(vector<uint8_t>& out) const {
+        size_t rows = offsets.size();
+        vector<string_view> sorted(rows);
+        for (size_t r = 0; r < rows; ++r) sorted[r] = entry(r);
+        sort(sorted.begin(), sorted.end());
+        sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+        if (sorted.size() > 65536) return false;
+
+        size_t codeBytes = (sorted.size() <= 256) ? 1 : 2;
+        size_t entryBytes = 0;
+        for (string_view v : sorted) entryBytes += v.size();
+        if (4 + sorted.size() * 4 + entryBytes + rows * codeBytes >= rows * 4 + heap.size()) return false;
+
+        uint32_t entries = static_cast<uint32_t>(sorted.size());
+        put(out, &entries, 4);
+        uint32_t endOffset = 0;
+        for (string_view v : sorted) {
+            endOffset += static_cast<uint32_t>(v.size());
+            put(out, &endOffset, 4);
+        }
+        for (string_view v : sorted) put(out, v.data(), v.size());
+        for (size_t r = 0; r < rows; ++r) {
+            uint16_t code = static_cast<uint16_t>(lower_bound(sorted.begin(), sorted.end(), entry(r)) - sorted.begin());
+            put(out, &code, codeBytes);
+        }
+        return true;
+    }
+
+    ColumnStore::Encoding ColumnStore::Chunk::encode(vector<uint8_t>& out, bool compress) const {
+        if (type == DataType::FLOAT) {
+            put(out, floats.data(), floats.size() * 4);
+            return Encoding::PLAIN;
+        }
+        if (type == DataType::STRING) {
+            if (compress && encoding == Encoding::PLAIN && encodeDictionary(out)) return Encoding::DICTIONARY;
+            put(out, offsets.data(), offsets.size() * 4);
+            put(out, heap.data(), heap.size());
+            return Encoding::PLAIN;
+        }
+
+        // INT: runs of equal values (categories, flags) or small steps (ids, timestamps)
+        size_t rows = ints.size();
+        size_t plainBytes = rows * 4, runBytes = 4, deltaBytes = 4;
+        for (size_t r = 0; compress && r < rows; ++r) {
+            if (r == 0 || ints[r] != ints[r - 1]) runBytes += 8;
+            if (r > 0) deltaBytes += varintBytes(zigzag(static_cast<int64_t>(ints[r]) - ints[r - 1]));
+        }
+        if (compress && rows > 0 && runBytes < plainBytes && runBytes <= deltaBytes) {
+            vector<pair<int32_t, uint32_t>> runs;
+            for (int32_t v : ints) {
+                if (runs.empty() || runs.back().first != v) runs.push_back({v, 0});
+                runs.back().second++;
+            }
+            uint32_t count = static_cast<uint32_t>(runs.size());
+            put(out, &count, 4);
+            for (const auto& [v, length] : runs) {
+                put(out, &v, 4);
+                put(out, &length, 4);
+            }
+            return Encoding::RUN_LENGTH;
+        }
+        if (compress && rows > 0 && deltaBytes < plainBytes) {
+            put(out, &ints[0], 4);
+            for (size_t r = 1; r < rows; ++r) putVarint(out, zigzag(static_cast<int64_t>(ints[r]) - ints[r - 1]));
+            return Encoding::DELTA;
+        }
+        put(out, ints.data(), plainBytes);
+        return Encoding::PLAIN;
+    }
+
+    bool ColumnStore::Chunk::decode(const uint8_t* in, size_t bytes, uint32_t rows, Encoding from) {
+        size_t fixed = static_cast<size_t>(rows) * 4;
+        const uint8_t* end = in + bytes;
+        encoding = Encoding::PLAIN;
+
+        if (type == DataType::INT && from == Encoding::RUN_LENGTH) {
+            uint32_t count = 0;
+            if (bytes < 4) return false;
+            memcpy(&count, in, 4);
+            if (bytes != 4 + static_cast<size_t>(count) * 8) return false;
+            ints.clear();
+            ints.reserve(rows);
+            for (uint32_t i = 0; i < count; ++i) {
+                int32_t v = 0;
+                uint32_t length = 0;
+                memcpy(&v, in + 4 + i * 8, 4);
+                memcpy(&length, in + 8 + i * 8, 4);
+                if (length > rows - ints.size()) return false;
+                ints.insert(ints.end(), length, v);
+            }
+            return ints.size() == rows;
+        }
+        if (type == DataType::INT && from == Encoding::DELTA) {
+            if (rows == 0 || bytes < 4) return false;
+            ints.resize(rows);
+            memcpy(&ints[0], in, 4);
+            const uint8_t* p = in + 4;
+            for (uint32_t r = 1; r < rows; ++r) {
+                uint64_t z = 0;
+                if (!getVarint(p, end, z)) return false;
+                ints[r] = static_cast<int32_t>(ints[r - 1] + unzigzag(z));
+            }
+            return p == end;
+        }
+        if (type == DataType::STRING && from == Encoding::DICTIONARY) {
+            uint32_t entries = 0;
+            if (bytes < 4) return false;
+            memcpy(&entries, in, 4);
+            size_t codeBytes = (entries <= 256) ? 1 : 2;
+            size_t table = 4 + static_cast<size_t>(entries) * 4;
+            if (entries == 0 || entries > 65536 || bytes < table + rows * codeBytes) return false;
+            offsets.resize(entries);
+            memcpy(offsets.data(), in + 4, entries * 4);
+            size_t heapBytes = bytes - table - rows * codeBytes;
+            heap.assign(reinterpret_cast<const char*>(in) + table, heapBytes);
+            for (uint32_t i = 0; i < entries; ++i)
+                if (offsets[i] > heap.size() || (i > 0 && offsets[i] < offsets[i - 1])) return false;
+            if (offsets[entries - 1] != heap.size()) return false;
+
+            codes.assign(rows, 0);
+            const uint8_t* c = in + table + heapBytes;
+            for (uint32_t r = 0; r < rows; ++r) {
+                memcpy(&codes[r], c + r * codeBytes, codeBytes);
+                if (codes[r] >= entries) return false;
+            }
+            encoding = Encoding::DICTIONARY;
+            return true;
+        }
+        if (from != Encoding::PLAIN) return false;
+
+        switch (type) {
+            case DataType::INT:
+                if (bytes != fixed) return false;
+                ints.resize(rows);
+                memcpy(ints.data(), in, fixed);
+                return true;
+            case DataType::FLOAT:
+                if (bytes != fixed) return false;
+                floats.resize(rows);
+                memcpy(floats.data(), in, fixed);
+                return true;
+            default:
+                if (bytes < fixed) return false;
+                offsets.resize(rows);
+                memcpy(offsets.data(), in, fixed);
+                heap.assign(reinterpret_cast<const char*>(in) + fixed, bytes - fixed);
+                for (uint32_t i = 0; i < rows; ++i)
+                    if (offsets[i] > heap.size() || (i > 0 && offsets[i] < offsets[i - 1])) return false;
+                return rows == 0 ? heap.empty() : offsets[rows - 1] == heap.size();
+        }
+    }
+
+    // --- Store ---
+    ColumnStore::ColumnStore(const string& basePath, const vector<DataType>& columnTypes, bool compressed)
+        : base(basePath), types(columnTypes), compress(compressed) {
+        resetTail();
+    }
+
+    string ColumnStore::segmentPath(size_t column) const {
+        return base + "." + to_string(column) + ".seg";
+    }
+
+    string ColumnStore::manifestPath() const {
+        return base + ".colm";
+    }
+
+    void ColumnStore::resetTail() {
+        tail.assign(types.size(), Chunk());
+        for (size_t c = 0; c < types.size(); ++c) tail[c].type = types[c];
+    }
+
+    bool ColumnStore::create() {
+        groups.clear();
+        resetTail();
+        for (size_t c = 0; c < types.size(); ++c) {
+            DurableFile seg;
+            if (!seg.open(segmentPath(c), true)) return false;
+        }
+        return writeManifest(0);
+    }
+
+    void ColumnStore::append(const Record& rec) {
+        for (size_t c = 0; c < types.size(); ++c) tail[c].append(rec.fields[c]);
+        if (!types.empty() && tail[0].size() >= ROW_GROUP_ROWS) {
+            Group g;
+            g.rows = static_cast<uint32_t>(tail[0].size());
+            g.pending = move(tail);
+            groups.push_back(move(g));
+            resetTail();
+        }
+    }
+
+    uint64_t ColumnStore::rowCount() const {
+        uint64_t rows = types.empty() ? 0 : tail[0].size();
+        for (const Group& g : groups) rows += g.rows;
+        return rows;
+    }
+
+    uint64_t ColumnStore::segmentBytes() const {
+        uint64_t bytes = 0;
+        for (const Group& g : groups)
+            for (const Extent& e : g.extents) bytes += e.bytes;
+        return bytes;
+    }
+
+    uint32_t ColumnStore::groupCount() const {
+        bool tailRows = !types.empty() && tail[0].size() > 0;
+        return static_cast<uint32_t>(groups.size()) + (tailRows ? 1 : 0);
+    }
+
+    uint32_t ColumnStore::groupRows(uint32_t group) const {
+        if (group < groups.size()) return groups[group].rows;
+        return types.empty() ? 0 : static_cast<uint32_t>(tail[0].size());
+    }
+
+    const ColumnStore::Chunk* ColumnStore::chunk(uint32_t group, uint16_t column, Chunk& buffer) const {
+        if (column >= types.size()) return nullptr;
+        if (group >= groups.size()) return &tail[column];
+        const Group& g = groups[group];
+        if (!g.pending.empty()) return &g.pending[column];
+
+        const Extent& e = g.extents[column];
+        ifstream in(segmentPath(column), ios::binary);
+        if (!in) return nullptr;
+        vector<uint8_t> raw(e.bytes);
+        in.seekg(static_cast<streamoff>(e.offset));
+        if (!in.read(reinterpret_cast<char*>(raw.data()), e.bytes)) return nullptr;
+        readBytes += e.bytes;
+
+        buffer = Chunk();
+        buffer.type = types[column];
+        return buffer.decode(raw.data(), raw.size(), g.rows, e.encoding) ? &buffer : nullptr;
+    }
+
+    // Seals the full row groups: their chunks are appended to the segment files (cut back
+    // first to the bytes the manifest knows about) and synced before the manifest names them.
+    bool ColumnStore::checkpoint(uint64_t lsn) {
+        size_t first = 0;
+        while (first < groups.size() && groups[first].pending.empty()) first++;
+
+        if (first < groups.size()) {
+            vector<vector<Extent>> extents(groups.size() - first);
+            vector<uint8_t> bytes;
+            for (size_t c = 0; c < types.size(); ++c) {
+                uint64_t end = 0;
+                if (first > 0) end = groups[first - 1].extents[c].offset + groups[first - 1].extents[c].bytes;
+
+                DurableFile seg;
+                if (!seg.open(segmentPath(c))) return false;
+                if (seg.size() != end && !seg.truncate(end)) return false;
+                for (size_t g = first; g < groups.size(); ++g) {
+                    bytes.clear();
+                    Encoding encoding = groups[g].pending[c].encode(bytes, compress);
+                    if (!seg.append(bytes.data(), bytes.size())) return false;
+                    extents[g - first].push_back({end, static_cast<uint32_t>(bytes.size()), encoding});
+                    end += bytes.size();
+                }
+                if (!seg.sync()) return false;
+            }
+            for (size_t g = first; g < groups.size(); ++g) groups[g].extents = move(extents[g - first]);
+        }
+
+        if (!writeManifest(lsn)) {
+            for (size_t g = first; g < groups.size(); ++g) groups[g].extents.clear();
+            return false;
+        }
+        for (size_t g = first; g < groups.size(); ++g) groups[g].pending.clear();
+        return true;
+    }
+
+    bool ColumnStore::writeManifest(uint64_t lsn) const {
+        vector<uint8_t> out = {'C', 'C', 'O', 'L', VERSION, static_cast<uint8_t>(types.size()), 0, 0};
+        auto put = [&out](const void* data, size_t bytes) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), p, p + bytes);
+        };
+        uint32_t groupTotal = static_cast<uint32_t>(groups.size());
+        put(&lsn, 8);
+        put(&groupTotal, 4);
+        for (const Group& g : groups) {
+            put(&g.rows, 4);
+            for (const Extent& e : g.extents) {
+                put(&e.offset, 8);
+                put(&e.bytes, 4);
+                out.push_back(static_cast<uint8_t>(e.encoding));
+            }
+        }
+
+        uint32_t tailRows = groupRows(groupTotal);
+        put(&tailRows, 4);
+        vector<uint8_t> bytes;
+        for (const Chunk& c : tail) {
+            bytes.clear();
+            c.encode(bytes, false);
+            uint32_t len = static_cast<uint32_t>(bytes.size());
+            put(&len, 4);
+            put(bytes.data(), bytes.size());
+        }
+        uint32_t crc = crc32(out.data(), out.size());
+        put(&crc, 4);
+
+        string path = manifestPath();
+        string tmp = path + ".tmp";
+        {
+            ofstream f(tmp, ios::binary | ios::trunc);
+            if (!f) return false;
+            f.write(reinterpret_cast<const char*>(out.data()), out.size());
+            if (!f) return false;
+        }
+        if (!syncFile(tmp)) return false;
+        error_code ec;
+        fs::rename(tmp, path, ec);
+        return !ec;
+    }
+
+    bool ColumnStore::load(uint64_t& lsn) {
+        lsn = 0;
+        groups.clear();
+        resetTail();
+
+        ifstream f(manifestPath(), ios::binary | ios::ate);
+        if (!f) return false;
+        vector<uint8_t> in(static_cast<size_t>(f.tellg()));
+        f.seekg(0);
+        f.read(reinterpret_cast<char*>(in.data()), in.size());
+        if (in.size() < 28 || memcmp(in.data(), "CCOL", 4) != 0 || in[4] < 1 || in[4] > VERSION || in[5] != types.size()) return false;
+        uint32_t crc = 0;
+        memcpy(&crc, in.data() + in.size() - 4, 4);
+        if (crc32(in.data(), in.size() - 4) != crc) return false;
+
+        size_t pos = 8, end = in.size() - 4;
+        auto get = [&](void* data, size_t bytes) {
+            if (pos + bytes > end) return false;
+            memcpy(data, in.data() + pos, bytes);
+            pos += bytes;
+            return true;
+        };
+        uint64_t savedLSN = 0;
+        uint32_t groupTotal = 0;
+        if (!get(&savedLSN, 8) || !get(&groupTotal, 4)) return false;
+
+        vector<Group> loaded(groupTotal);
+        for (Group& g : loaded) {
+            if (!get(&g.rows, 4)) return false;
+            g.extents.resize(types.size());
+            for (Extent& e : g.extents) {
+                if (!get(&e.offset, 8) || !get(&e.bytes, 4)) return false;
+                uint8_t encoding = 0;
+                if (in[4] >= 2 && !get(&encoding, 1)) return false;
+                if (encoding > static_cast<uint8_t>(Encoding::DELTA)) return false;
+                e.encoding = static_cast<Encoding>(encoding);
+            }
+        }
+
+        uint32_t tailRows = 0;
+        if (!get(&tailRows, 4)) return false;
+        for (Chunk& c : tail) {
+            uint32_t len = 0;
+            if (!get(&len, 4) || pos + len > end) return false;
+            if (!c.decode(in.data() + pos, len, tailRows, Encoding::PLAIN)) return false;
+            pos += len;
+        }
+
+        groups = move(loaded);
+        lsn = savedLSN;
+        return true;
+    }
+
+    // --- Scans ---
+    // Works one row group at a time: the predicate column is read first and turned into a
+    // selection vector of matching rows; only then are the projected columns read, and not
+    // at all for groups without a match.
+    class ColumnCursor : public Cursor {
+    public:
+        ColumnCursor(const ColumnStore& columnStore, optional<ScanPredicate> predicate, vector<uint16_t> columnList)
+            : store(columnStore), where(move(predicate)), columns(move(columnList)),
+              buffers(columns.size()), chunks(columns.size(), nullptr) {}
+
+        bool next(Record& out) override {
+            while (open) {
+                if (pos < selection.size()) {
+                    uint32_t row = selection[pos++];
+                    out.fields.clear();
+                    for (const ColumnStore::Chunk* c : chunks) out.fields.push_back(c->value(row));
+                    return true;
+                }
+                if (group >= store.groupCount() || !loadGroup(group++)) open = false;
+            }
+            return false;
+        }
+
+        void close() override { open = false; }
+
+    private:
+        const ColumnStore& store;
+        optional<ScanPredicate> where;
+        vector<uint16_t> columns;
+        vector<ColumnStore::Chunk> buffers;
+        vector<const ColumnStore::Chunk*> chunks;
+        ColumnStore::Chunk whereBuffer;
+        vector<uint32_t> selection;
+        size_t pos = 0;
+        uint32_t group = 0;
+        bool open = true;
+
+        // false if a chunk cannot be read
+        bool loadGroup(uint32_t g) {
+            uint32_t rows = store.groupRows(g);
+            selection.clear();
+            pos = 0;
+
+            const ColumnStore::Chunk* filter = nullptr;
+            if (where) {
+                if (where->column >= store.columnCount()) return true; // matches nothing
+                filter = store.chunk(g, where->column, whereBuffer);
+                if (!filter) return false;
+                filter->select(*where, selection);
+                if (selection.empty()) return true;
+            } else {
+                selection.resize(rows);
+                for (uint32_t r = 0; r < rows; ++r) selection[r] = r;
+            }
+
+            for (size_t i = 0; i < columns.size(); ++i) {
+                chunks[i] = (filter && columns[i] == where->column) ? filter : store.chunk(g, columns[i], buffers[i]);
+                if (!chunks[i]) return false;
+            }
+            return true;
+        }
+    };
+
+    unique_ptr<Cursor> ColumnStore::openCursor(optional<ScanPredicate> where, vector<uint16_t> columns) const {
+        if (columns.empty())
+            for (size_t c = 0; c < types.size(); ++c) columns.push_back(static_cast<uint16_t>(c));
+        for (uint16_t c : columns)
+            if (c >= types.size()) return nullptr;
+        return make_unique<ColumnCursor>(*this, move(where), move(columns));
+    }
+
+    optional<Record> ColumnStore::findById(int id) const {
+        if (types.empty() || types[0] != DataType::INT) return nullopt;
+        Chunk idBuffer, buffer;
+        for (uint32_t g = groupCount(); g-- > 0;) {
+            const Chunk* ids = chunk(g, 0, idBuffer);
+            if (!ids) return nullopt;
+            for (size_t r = ids->ints.size(); r-- > 0;) {
+                if (ids->ints[r] != id) continue;
+                Record rec;
+                rec.fields.push_back(id);
+                for (uint16_t c = 1; c < types.size(); ++c) {
+                    const Chunk* col = chunk(g, c, buffer);
+                    if (!col) return nullopt;
+                    rec.fields.push_back(col->value(r));
+                }
+                return rec;
+            }
+        }
+        return nullopt;
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,130 @@
+#ifndef CHRONODB_COLUMN_STORE_H
+#define CHRONODB_COLUMN_STORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include "../utils/types.h"
+#include "cursor.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Columnar table (USING COLUMNAR): every column lives in its own segment file of
+    // contiguous typed arrays, cut into row groups of ROW_GROUP_ROWS rows, so a scan
+    // reads only the columns it touches.
+    //
+    // Segment file (<table>.<column number>.seg): row-group chunks back to back, each in
+    // one of the Encoding formats
+    //   PLAIN       INT / FLOAT : rows x 4-byte values
+    //               STRING      : rows x u32 end offset into the heap | heap bytes
+    //   DICTIONARY  STRING      : entries:u32 | entries x u32 end offset | heap
+    //                             | rows x code (u8 up to 256 entries, else u16)
+    //   RUN_LENGTH  INT         : runs:u32 | runs x (value:i32, length:u32)
+    //   DELTA       INT         : first:i32 | rows-1 x zigzag varint of the difference
+    // Compressed tables pick the smallest encoding per chunk when it is sealed; dictionary
+    // entries are sorted, so codes compare in the same order as the strings.
+    // Manifest (<table>.colm), rewritten at checkpoint (temp file + rename):
+    //   "CCOL" | version:u8 | columns:u8 | pad:u16 | lsn:u64 | groups:u32
+    //   | per group: rows:u32 + per column (offset:u64, bytes:u32, encoding:u8)
+    //   | tailRows:u32 | per column: bytes:u32 + PLAIN chunk | crc32:u32
+    // (version 1 files have no encoding byte: every chunk is PLAIN)
+    // New rows collect in memory. checkpoint() appends each full row group to the
+    // segment files before publishing it in the manifest; the rest (the tail) is stored
+    // in the manifest itself. Segment bytes the manifest does not reference (a crash
+    // in between) are cut off by the next checkpoint. Rows are append-only: ids are not
+    // deduplicated, and UPDATE / DELETE are not supported.
+    class ColumnStore {
+    public:
+        static constexpr uint32_t ROW_GROUP_ROWS = 64 * 1024;
+
+        enum class Encoding : uint8_t { PLAIN, DICTIONARY, RUN_LENGTH, DELTA };
+
+        // One column of one row group. INT chunks are always expanded in memory; STRING
+        // chunks read from a DICTIONARY segment stay encoded: offsets/heap then hold the
+        // sorted entries and codes the entry of each row.
+        struct Chunk {
+            DataType type = DataType::INT;
+            Encoding encoding = Encoding::PLAIN;
+            vector<int32_t> ints;
+            vector<float> floats;
+            vector<uint32_t> offsets; // STRING: end of each value (or entry) in heap
+            string heap;
+            vector<uint16_t> codes;   // DICTIONARY: entry of each row
+
+            size_t size() const;
+            void append(const RecordValue& v);
+            RecordValue value(size_t row) const;
+            string_view stringAt(size_t row) const;
+            bool matches(size_t row, const ScanPredicate& where) const;
+            // Rows of [0, rows) matching where, added to selection. Dictionary chunks test
+            // each entry once and then compare codes only.
+            void select(const ScanPredicate& where, vector<uint32_t>& selection) const;
+            // Writes the chunk in the smallest encoding allowed (PLAIN only if !compress)
+            Encoding encode(vector<uint8_t>& out, bool compress) const;
+            bool decode(const uint8_t* in, size_t bytes, uint32_t rows, Encoding from);
+
+        private:
+            string_view entry(size_t index) const;
+            bool encodeDictionary(vector<uint8_t>& out) const;
+        };
+
+        ColumnStore() = default;
+        ColumnStore(const string& basePath, const vector<DataType>& columnTypes, bool compressed = false);
+
+        bool create();              // empty segment files and manifest
+        bool load(uint64_t& lsn);   // false if the manifest is missing or damaged
+        bool checkpoint(uint64_t lsn);
+
+        void append(const Record& rec); // fields must match the column types
+        uint64_t rowCount() const;
+        size_t columnCount() const { return types.size(); }
+
+        // Row groups: the sealed ones, then the tail if it holds rows
+        uint32_t groupCount() const;
+        uint32_t groupRows(uint32_t group) const;
+        // Column of a row group: in-memory chunks are returned in place, chunks on disk
+        // are read into buffer. nullptr if the segment cannot be read.
+        const Chunk* chunk(uint32_t group, uint16_t column, Chunk& buffer) const;
+        uint64_t bytesRead() const { return readBytes; }
+        uint64_t segmentBytes() const; // sealed chunks as stored on disk
+
+        // Rows matching where, holding only the listed columns (all if empty)
+        unique_ptr<Cursor> openCursor(optional<ScanPredicate> where, vector<uint16_t> columns) const;
+        // Newest row with this id (reads the id column, then one row group)
+        optional<Record> findById(int id) const;
+
+    private:
+        static constexpr uint8_t VERSION = 2;
+
+        struct Extent {
+            uint64_t offset = 0; // in the column's segment file
+            uint32_t bytes = 0;
+            Encoding encoding = Encoding::PLAIN;
+        };
+
+        struct Group {
+            uint32_t rows = 0;
+            vector<Extent> extents;   // per column
+            vector<Chunk> pending;    // full group not yet written (until checkpoint)
+        };
+
+        string base; // <dir>/<table>
+        vector<DataType> types;
+        bool compress = false;
+        vector<Group> groups;
+        vector<Chunk> tail;
+        mutable uint64_t readBytes = 0;
+
+        string segmentPath(size_t column) const;
+        string manifestPath() const;
+        void resetTail();
+        bool writeManifest(uint64_t lsn) const;
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_COLUMN_STORE_H
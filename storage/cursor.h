@@ -0,0 +1,79 @@
+#ifndef CHRONODB_CURSOR_H
+#define CHRONODB_CURSOR_H
+
+#include <optional>
+#include <memory>
+#include <vector>
+#include "../utils/types.h"
+#include "record_view.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Pull-based row cursor (open -> next ... -> close).
+    // Rows are produced one at a time, so callers can filter or stop early
+    // without materializing the whole table. A cursor is invalidated by
+    // writes to the table it scans.
+    class Cursor {
+    public:
+        virtual ~Cursor() = default;
+
+        // Copies the next row into out; false once the cursor is exhausted or closed
+        virtual bool next(Record& out) = 0;
+        // Releases the cursor's resources early (also done by the destructor)
+        virtual void close() = 0;
+    };
+
+    // Cursor over an in-memory structure iterator (AVL/BST in-order, HASH insertion order).
+    // Iterator::next() returns a const Record* or nullptr at the end.
+    // Rows rejected by the predicate are skipped without being copied.
+    template <typename Iterator>
+    class StructureCursor : public Cursor {
+    public:
+        StructureCursor(Iterator iterator, optional<ScanPredicate> predicate)
+            : it(move(iterator)), where(move(predicate)) {}
+
+        bool next(Record& out) override {
+            if (!open) return false;
+            for (const Record* rec = it.next(); rec; rec = it.next()) {
+                if (where && !where->matches(*rec)) continue;
+                out = *rec;
+                return true;
+            }
+            open = false;
+            return false;
+        }
+
+        void close() override { open = false; }
+
+    private:
+        Iterator it;
+        optional<ScanPredicate> where;
+        bool open = true;
+    };
+
+    // Keeps only the given columns of each row (in the given order) of another cursor
+    class ProjectingCursor : public Cursor {
+    public:
+        ProjectingCursor(unique_ptr<Cursor> source, vector<uint16_t> columnList)
+            : inner(move(source)), columns(move(columnList)) {}
+
+        bool next(Record& out) override {
+            if (!inner->next(row)) return false;
+            out.fields.clear();
+            for (uint16_t c : columns)
+                if (c < row.fields.size()) out.fields.push_back(row.fields[c]);
+            return true;
+        }
+
+        void close() override { inner->close(); }
+
+    private:
+        unique_ptr<Cursor> inner;
+        vector<uint16_t> columns;
+        Record row;
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_CURSOR_H
@@ -0,0 +1,99 @@
+// file_io.cpp
+#include "file_io.h"
+#include <array>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define CHRONO_OPEN _open
+#define CHRONO_CLOSE _close
+#define CHRONO_WRITE _write
+#define CHRONO_FSYNC _commit
+#define CHRONO_BINARY _O_BINARY
+#else
+#include <unistd.h>
+#define CHRONO_OPEN ::open
+#define CHRONO_CLOSE ::close
+#define CHRONO_WRITE ::write
+#define CHRONO_FSYNC ::fsync
+#define CHRONO_BINARY 0
+#endif
+
+namespace ChronoDB {
+
+    DurableFile::~DurableFile() {
+        close();
+    }
+
+    bool DurableFile::open(const string& path, bool truncate) {
+        close();
+        int flags = O_RDWR | O_CREAT | O_APPEND | CHRONO_BINARY | (truncate ? O_TRUNC : 0);
+        fd = CHRONO_OPEN(path.c_str(), flags, 0644);
+        return fd >= 0;
+    }
+
+    void DurableFile::close() {
+        if (fd >= 0) CHRONO_CLOSE(fd);
+        fd = -1;
+    }
+
+    bool DurableFile::append(const void* data, size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            auto n = CHRONO_WRITE(fd, p, static_cast<unsigned int>(size));
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool DurableFile::sync() {
+        return fd >= 0 && CHRONO_FSYNC(fd) == 0;
+    }
+
+    bool DurableFile::truncate(uint64_t size) {
+#ifdef _WIN32
+        return fd >= 0 && _chsize_s(fd, static_cast<long long>(size)) == 0;
+#else
+        return fd >= 0 && ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    uint64_t DurableFile::size() const {
+        if (fd < 0) return 0;
+#ifdef _WIN32
+        struct _stat64 st;
+        if (_fstat64(fd, &st) != 0) return 0;
+#else
+        struct stat st;
+        if (fstat(fd, &st) != 0) return 0;
+#endif
+        return static_cast<uint64_t>(st.st_size);
+    }
+
+    bool syncFile(const string& path) {
+        int fd = CHRONO_OPEN(path.c_str(), O_RDWR | CHRONO_BINARY);
+        if (fd < 0) return false;
+        bool ok = CHRONO_FSYNC(fd) == 0;
+        CHRONO_CLOSE(fd);
+        return ok;
+    }
+
+    uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+        static const array<uint32_t, 256> table = [] {
+            array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                t[i] = c;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,41 @@
+#ifndef CHRONODB_FILE_IO_H
+#define CHRONODB_FILE_IO_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+namespace ChronoDB {
+
+    // Append-only file with an explicit durability point (fsync / _commit).
+    // Used for the write-ahead log and the double-write buffer.
+    class DurableFile {
+    public:
+        DurableFile() = default;
+        ~DurableFile();
+        DurableFile(const DurableFile&) = delete;
+        DurableFile& operator=(const DurableFile&) = delete;
+
+        bool open(const string& path, bool truncate = false); // creates the file if missing
+        void close();
+        bool isOpen() const { return fd >= 0; }
+
+        bool append(const void* data, size_t size);
+        bool sync();                      // returns once the appended bytes are on stable storage
+        bool truncate(uint64_t size);
+        uint64_t size() const;
+
+    private:
+        int fd = -1;
+    };
+
+    // fsync an existing file by path (after writing it through an fstream)
+    bool syncFile(const string& path);
+
+    // CRC-32 (IEEE) used to detect torn log records and double-write batches
+    uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_FILE_IO_H
@@ -0,0 +1,113 @@
+// free_space_map.cpp
+#include "free_space_map.h"
+#include "file_io.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+using namespace std;
+
+namespace ChronoDB {
+
+    uint8_t FreeSpaceMap::category(uint16_t freeBytes) {
+        return static_cast<uint8_t>(min<uint32_t>(freeBytes / FSM_UNIT, 255));
+    }
+
+    bool FreeSpaceMap::load(uint32_t expectedPages) {
+        entries.clear();
+        dirty = false;
+
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in) return false;
+        vector<uint8_t> bytes(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+
+        if (bytes.size() < 16 || memcmp(bytes.data(), "CFSM", 4) != 0 || bytes[4] != VERSION) return false;
+        uint32_t pages = 0, crc = 0;
+        memcpy(&pages, bytes.data() + 8, 4);
+        if (pages != expectedPages || bytes.size() != 16 + static_cast<size_t>(pages)) return false;
+        memcpy(&crc, bytes.data() + bytes.size() - 4, 4);
+        if (crc32(bytes.data(), bytes.size() - 4) != crc) return false;
+
+        entries.assign(bytes.begin() + 12, bytes.begin() + 12 + pages);
+        rebuildTree(entries.size());
+        return true;
+    }
+
+    bool FreeSpaceMap::checkpoint() {
+        vector<uint8_t> out = {'C', 'F', 'S', 'M', VERSION, 0, 0, 0, 0, 0, 0, 0};
+        uint32_t pages = pageCount();
+        memcpy(out.data() + 8, &pages, 4);
+        out.insert(out.end(), entries.begin(), entries.end());
+        uint32_t crc = crc32(out.data(), out.size());
+        out.resize(out.size() + 4);
+        memcpy(out.data() + out.size() - 4, &crc, 4);
+
+        ofstream f(path, ios::binary | ios::trunc);
+        if (!f) return false;
+        f.write(reinterpret_cast<const char*>(out.data()), out.size());
+        if (!f) return false;
+        dirty = false;
+        return true;
+    }
+
+    void FreeSpaceMap::reset(const vector<uint16_t>& freeBytesPerPage) {
+        entries.resize(freeBytesPerPage.size());
+        for (size_t i = 0; i < entries.size(); ++i) entries[i] = category(freeBytesPerPage[i]);
+        rebuildTree(entries.size());
+        dirty = true;
+    }
+
+    void FreeSpaceMap::update(uint32_t pageIndex, uint16_t freeBytes) {
+        uint8_t value = category(freeBytes);
+        if (pageIndex >= entries.size()) {
+            entries.resize(static_cast<size_t>(pageIndex) + 1, 0);
+            if (entries.size() > leaves) rebuildTree(entries.size()); // doubles, so amortized O(1)
+        } else if (entries[pageIndex] == value) {
+            return;
+        }
+        entries[pageIndex] = value;
+        setLeaf(pageIndex, value);
+        dirty = true;
+    }
+
+    void FreeSpaceMap::truncate(uint32_t pages) {
+        if (pages >= entries.size()) return;
+        for (size_t i = pages; i < entries.size(); ++i) setLeaf(i, 0);
+        entries.resize(pages);
+        dirty = true;
+    }
+
+    optional<uint32_t> FreeSpaceMap::findPage(uint16_t bytes) const {
+        // round up: category c guarantees at least c * FSM_UNIT bytes
+        uint32_t need = (static_cast<uint32_t>(bytes) + FSM_UNIT - 1) / FSM_UNIT;
+        if (need > 255 || leaves == 0 || tree[1] < need) return nullopt;
+        size_t node = 1;
+        while (node < leaves) {
+            node = (tree[2 * node] >= need) ? 2 * node : 2 * node + 1;
+        }
+        return static_cast<uint32_t>(node - leaves);
+    }
+
+    void FreeSpaceMap::rebuildTree(size_t minLeaves) {
+        // power-of-two leaf count: growing past it doubles the tree
+        size_t size = 1;
+        while (size < minLeaves) size <<= 1;
+
+        leaves = size;
+        tree.assign(2 * leaves, 0);
+        for (size_t i = 0; i < entries.size(); ++i) tree[leaves + i] = entries[i];
+        for (size_t i = leaves - 1; i >= 1; --i) tree[i] = max(tree[2 * i], tree[2 * i + 1]);
+    }
+
+    void FreeSpaceMap::setLeaf(size_t index, uint8_t value) {
+        size_t node = leaves + index;
+        tree[node] = value;
+        for (node /= 2; node >= 1; node /= 2) {
+            uint8_t m = max(tree[2 * node], tree[2 * node + 1]);
+            if (tree[node] == m) break;
+            tree[node] = m;
+        }
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,60 @@
+#ifndef CHRONODB_FREE_SPACE_MAP_H
+#define CHRONODB_FREE_SPACE_MAP_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include "page.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Free-space map for a HEAP table: one byte per page holding the page's reusable
+    // space (free + dead bytes) in FSM_UNIT steps, rounded down so an entry never
+    // promises more room than the page has.
+    //
+    // A max-tree over the entries finds the first page with enough room in O(log pages)
+    // without reading any page; updates are O(log pages) too.
+    //
+    // File layout (<table>.fsm), written at checkpoint:
+    //   "CFSM" | version:u8 | pad:3 | pageCount:u32 | entries (u8 per page) | crc32:u32
+    // The map is only a hint: a stale entry is corrected when an insert finds the page full,
+    // and a missing or damaged file is rebuilt from the pages.
+    class FreeSpaceMap {
+    public:
+        static constexpr uint16_t FSM_UNIT = PAGE_SIZE / 256; // 32 bytes per step
+
+        FreeSpaceMap() = default;
+        explicit FreeSpaceMap(const string& filePath) : path(filePath) {}
+
+        bool load(uint32_t expectedPages);                // false if missing, damaged or out of date
+        bool checkpoint();
+        void reset(const vector<uint16_t>& freeBytesPerPage);
+
+        void update(uint32_t pageIndex, uint16_t freeBytes); // grows the map for new pages
+        void truncate(uint32_t pages);
+        // First page with at least `bytes` reusable bytes
+        optional<uint32_t> findPage(uint16_t bytes) const;
+
+        uint32_t pageCount() const { return static_cast<uint32_t>(entries.size()); }
+        bool isDirty() const { return dirty; }
+
+        static uint8_t category(uint16_t freeBytes);
+
+    private:
+        static constexpr uint8_t VERSION = 1;
+
+        string path;
+        vector<uint8_t> entries;
+        vector<uint8_t> tree;     // max-tree: tree[leaves + i] = entries[i], tree[1] = overall max
+        size_t leaves = 0;
+        bool dirty = false;
+
+        void rebuildTree(size_t minLeaves);
+        void setLeaf(size_t index, uint8_t value);
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_FREE_SPACE_MAP_H
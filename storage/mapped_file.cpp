@@ -0,0 +1,96 @@
+// mapped_file.cpp
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ChronoDB {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const string& path, bool sequential) {
+        close();
+        DWORD flags = FILE_ATTRIBUTE_NORMAL | (sequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0);
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle = file;
+        mappingHandle = mapping;
+        base = static_cast<const uint8_t*>(view);
+        length = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (base) UnmapViewOfFile(base);
+        if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+        if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+        base = nullptr;
+        length = 0;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+    }
+#else
+    bool MappedFile::open(const string& path, bool sequential) {
+        close();
+        int handle = ::open(path.c_str(), O_RDONLY);
+        if (handle < 0) return false;
+
+        struct stat st;
+        if (fstat(handle, &st) != 0 || st.st_size == 0) {
+            ::close(handle);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, handle, 0);
+        if (view == MAP_FAILED) {
+            ::close(handle);
+            return false;
+        }
+        if (sequential) madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+        fd = handle;
+        base = static_cast<const uint8_t*>(view);
+        length = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (base) munmap(const_cast<uint8_t*>(base), length);
+        if (fd >= 0) ::close(fd);
+        base = nullptr;
+        length = 0;
+        fd = -1;
+    }
+#endif
+
+} // namespace ChronoDB
@@ -0,0 +1,42 @@
+#ifndef CHRONODB_MAPPED_FILE_H
+#define CHRONODB_MAPPED_FILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+namespace ChronoDB {
+
+    // Read-only memory mapping of a whole file (mmap on POSIX, a file mapping view on Windows).
+    // Used by the HEAP scan path so pages are parsed straight out of the page cache
+    // instead of being copied through ifstream::read into per-page buffers.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Maps the file; sequential = hint the kernel to read ahead aggressively
+        bool open(const string& path, bool sequential = true);
+        void close();
+
+        bool isOpen() const { return base != nullptr; }
+        const uint8_t* data() const { return base; }
+        size_t size() const { return length; }
+
+    private:
+        const uint8_t* base = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_MAPPED_FILE_H
@@ -0,0 +1,105 @@
+#ifndef CHRONODB_PAGE_H
+#define CHRONODB_PAGE_H
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+using namespace std;
+
+namespace ChronoDB {
+
+    // -------- Page Constants --------
+    static constexpr uint32_t PAGE_SIZE = 8192; // 8 KB
+    static constexpr uint16_t PAGE_HEADER_RESERVED = 64;
+    static constexpr uint16_t PAGE_COMPACT_THRESHOLD = PAGE_SIZE / 4; // dead bytes before a page is compacted
+
+    // Slot flags (stored next to the active bit in the slot directory)
+    static constexpr uint8_t SLOT_FORWARD = 0x02; // slot holds a 6-byte RID of the row's new location
+    static constexpr uint8_t SLOT_MOVED = 0x04;   // row was moved here; payload starts with the 6-byte home RID
+    static constexpr uint16_t FORWARD_STUB_BYTES = 6;
+
+    // Row encoding of a page (header byte 12). Older files have 0 there: tagged rows.
+    static constexpr uint8_t ROW_FORMAT_TAGGED = 0; // self-describing rows (StorageEngine::serializeRecord)
+    static constexpr uint8_t ROW_FORMAT_FIXED = 1;  // schema-driven rows (RowLayout in record_view.h)
+
+    // What a page holds (header byte 13). HEAP pages (and older files) have 0 there;
+    // the others are pages of a BTREE table file (btree.h).
+    static constexpr uint8_t PAGE_KIND_HEAP = 0;
+    static constexpr uint8_t PAGE_KIND_BTREE_META = 1;
+    static constexpr uint8_t PAGE_KIND_BTREE_LEAF = 2;
+    static constexpr uint8_t PAGE_KIND_BTREE_INTERNAL = 3;
+    static constexpr uint8_t PAGE_KIND_FREE = 4;
+
+    struct SlotEntry {
+        uint16_t offset;
+        uint16_t length;
+        bool active;
+        uint8_t flags;
+        SlotEntry(uint16_t o = 0, uint16_t l = 0, bool a = true, uint8_t f = 0)
+            : offset(o), length(l), active(a), flags(f) {}
+
+        bool isForward() const { return (flags & SLOT_FORWARD) != 0; }
+        bool isMoved() const { return (flags & SLOT_MOVED) != 0; }
+    };
+
+    // Physical location of a row inside a HEAP table file
+    struct RecordID {
+        uint32_t pageID;
+        uint16_t slotID;
+    };
+
+    struct Page {
+        uint32_t pageID = 0;
+        uint16_t slotCount = 0;
+        uint16_t freeSpaceOffset = PAGE_HEADER_RESERVED;
+        uint8_t rowFormat = ROW_FORMAT_TAGGED;
+        uint8_t kind = PAGE_KIND_HEAP;
+        uint32_t link = 0; // header bytes 4-7, B+Tree pages: next leaf / leftmost child / next free page
+
+        vector<SlotEntry> slots;
+        vector<uint8_t> data;
+
+        Page() {
+            data.resize(PAGE_SIZE, 0);
+        }
+
+        uint16_t usedDataBytes() const { return freeSpaceOffset; }
+        uint16_t freeSpace() const;
+        optional<uint16_t> insertRawRecord(const vector<uint8_t>& rec, uint8_t flags = 0);
+        bool replaceRecord(uint16_t slotID, const vector<uint8_t>& rec); // same slot id, in place or elsewhere in the page
+        bool deleteSlot(uint16_t slotID);
+        uint16_t deadBytes() const;      // bytes in the data area not owned by a live slot
+        uint16_t liveSlotCount() const;
+        uint16_t compact();              // squeeze out dead bytes (slot ids of live rows are kept), returns bytes reclaimed
+        bool readRawRecord(uint16_t slotID, vector<uint8_t>& out) const;
+        // Row bytes of a live slot (skips the home RID of moved rows; false for dead/forwarding slots)
+        bool recordBytes(uint16_t slotID, const uint8_t*& ptr, uint16_t& len) const;
+
+        // Forwarding pointers for rows that outgrew their page
+        optional<RecordID> forwardTarget(uint16_t slotID) const;
+        optional<RecordID> movedFrom(uint16_t slotID) const;
+        bool setForward(uint16_t slotID, const RecordID& target);
+        static void encodeRID(const RecordID& rid, uint8_t* out);
+        static RecordID decodeRID(const uint8_t* in);
+
+        void serializeToBuffer(vector<uint8_t>& buffer) const;
+        void deserializeFromBuffer(const vector<uint8_t>& buffer);
+    };
+
+    // Zero-copy, read-only view of a serialized page (e.g. inside a memory-mapped table file).
+    // Reads the header and slot directory in place instead of materializing a Page.
+    struct PageView {
+        const uint8_t* bytes = nullptr; // PAGE_SIZE bytes
+
+        explicit PageView(const uint8_t* pageBytes) : bytes(pageBytes) {}
+
+        uint16_t slotCount() const;
+        uint8_t rowFormat() const { return bytes[12]; }
+        SlotEntry slot(uint16_t slotID) const;
+        // Same contract as Page::recordBytes
+        bool recordBytes(uint16_t slotID, const uint8_t*& ptr, uint16_t& len) const;
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_PAGE_H
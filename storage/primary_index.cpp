@@ -0,0 +1,104 @@
+// primary_index.cpp
+#include "primary_index.h"
+#include <cstring>
+using namespace std;
+
+namespace ChronoDB {
+
+    void PrimaryIndex::writeHeader(ostream& out, bool clean) {
+        out.write("CIDX", 4);
+        char version = static_cast<char>(VERSION);
+        char flag = clean ? 1 : 0;
+        out.write(&version, 1);
+        out.write(&flag, 1);
+    }
+
+    bool PrimaryIndex::load() {
+        entries.clear();
+        dirty = false;
+
+        ifstream in(path, ios::binary);
+        if (!in) return false;
+
+        char header[HEADER_BYTES];
+        if (!in.read(header, HEADER_BYTES)) return false;
+        if (memcmp(header, "CIDX", 4) != 0 || header[4] != VERSION) return false;
+        if (header[5] != 1) return false; // not closed cleanly
+
+        uint8_t entry[ENTRY_BYTES];
+        while (in.read(reinterpret_cast<char*>(entry), ENTRY_BYTES)) {
+            int32_t id = 0;
+            memcpy(&id, entry + 1, 4);
+            if (entry[0] == 1) entries[id] = Page::decodeRID(entry + 5);
+            else entries.erase(id);
+        }
+        return true;
+    }
+
+    bool PrimaryIndex::checkpoint() {
+        if (log.is_open()) log.close();
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out) return false;
+        writeHeader(out, true);
+
+        uint8_t entry[ENTRY_BYTES];
+        for (const auto& [id, rid] : entries) {
+            entry[0] = 1;
+            memcpy(entry + 1, &id, 4);
+            Page::encodeRID(rid, entry + 5);
+            out.write(reinterpret_cast<const char*>(entry), ENTRY_BYTES);
+        }
+        out.close();
+        dirty = false;
+        return true;
+    }
+
+    void PrimaryIndex::reset(unordered_map<int, RecordID>&& all) {
+        if (log.is_open()) log.close();
+        entries = move(all);
+        dirty = true;
+    }
+
+    optional<RecordID> PrimaryIndex::find(int id) const {
+        auto it = entries.find(id);
+        if (it == entries.end()) return nullopt;
+        return it->second;
+    }
+
+    void PrimaryIndex::put(int id, const RecordID& rid) {
+        entries[id] = rid;
+        appendLog(1, id, rid);
+    }
+
+    void PrimaryIndex::erase(int id) {
+        if (entries.erase(id) == 0) return;
+        appendLog(0, id, RecordID{0, 0});
+    }
+
+    void PrimaryIndex::appendLog(uint8_t op, int id, const RecordID& rid) {
+        if (!log.is_open()) {
+            // first change since the last checkpoint: flag the file as not clean
+            {
+                fstream header(path, ios::binary | ios::in | ios::out);
+                if (!header) {
+                    ofstream fresh(path, ios::binary | ios::trunc);
+                    writeHeader(fresh, false);
+                } else {
+                    header.seekp(5);
+                    char flag = 0;
+                    header.write(&flag, 1);
+                }
+            }
+            log.open(path, ios::binary | ios::app);
+        }
+        dirty = true;
+
+        uint8_t entry[ENTRY_BYTES];
+        entry[0] = op;
+        memcpy(entry + 1, &id, 4);
+        Page::encodeRID(rid, entry + 5);
+        log.write(reinterpret_cast<const char*>(entry), ENTRY_BYTES);
+    }
+
+} // namespace ChronoDB
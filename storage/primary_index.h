@@ -0,0 +1,57 @@
+#ifndef CHRONODB_PRIMARY_INDEX_H
+#define CHRONODB_PRIMARY_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+#include "page.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Persistent primary-key index for a HEAP table: id -> home RID (page, slot).
+    //
+    // File layout (<table>.idx):
+    //   header  : "CIDX" | version:u8 | clean:u8
+    //   entries : op:u8 (1 = put, 0 = erase) | id:i32 | pageID:u32 | slotID:u16
+    //
+    // Changes are appended to the file as they happen; checkpoint() rewrites it as a
+    // compact snapshot and marks it clean. An index that was not closed cleanly
+    // (e.g. after a crash) fails to load and is rebuilt from the table pages.
+    class PrimaryIndex {
+    public:
+        PrimaryIndex() = default;
+        explicit PrimaryIndex(const string& filePath) : path(filePath) {}
+
+        bool load();                                  // false if missing, corrupt or not clean
+        bool checkpoint();                            // snapshot + clean flag
+        void reset(unordered_map<int, RecordID>&& all); // replace contents (after a rebuild)
+
+        optional<RecordID> find(int id) const;
+        void put(int id, const RecordID& rid);
+        void erase(int id);
+
+        size_t size() const { return entries.size(); }
+        bool isDirty() const { return dirty; }
+        const unordered_map<int, RecordID>& all() const { return entries; }
+
+    private:
+        static constexpr uint8_t VERSION = 1;
+        static constexpr size_t HEADER_BYTES = 6;
+        static constexpr size_t ENTRY_BYTES = 11;
+
+        string path;
+        unordered_map<int, RecordID> entries;
+        ofstream log;
+        bool dirty = false;
+
+        void appendLog(uint8_t op, int id, const RecordID& rid);
+        static void writeHeader(ostream& out, bool clean);
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_PRIMARY_INDEX_H
@@ -0,0 +1,344 @@
+#ifndef CHRONODB_RECORD_VIEW_H
+#define CHRONODB_RECORD_VIEW_H
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "../utils/types.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Schema-driven row layout, used by HEAP pages in ROW_FORMAT_FIXED. Built once per table
+    // from the column types; a row carries no field count, type tags or per-field lengths:
+    //   INT/FLOAT columns : 4 bytes each, at offsets fixed by the schema (in column order)
+    //   null bitmap       : ceil(columns / 8) bytes, bit i set when column i is NULL
+    //   string offsets    : u16 per STRING column, end of that string in the string area
+    //   string area       : STRING values back to back
+    // Column k is read in O(1) from the precomputed offsets. RecordValue has no NULL yet,
+    // so encode() always writes a clear bitmap; readers treat a set bit as a missing value.
+    struct RowLayout {
+        vector<DataType> types;
+        vector<uint16_t> position; // INT/FLOAT: byte offset; STRING: index in the offset table
+        uint16_t fixedBytes = 0;
+        uint16_t nullBytes = 0;
+        uint16_t stringCount = 0;
+
+        RowLayout() = default;
+        explicit RowLayout(const vector<DataType>& columnTypes) : types(columnTypes) {
+            for (DataType t : types) {
+                if (t == DataType::STRING) {
+                    position.push_back(stringCount++);
+                } else {
+                    position.push_back(fixedBytes);
+                    fixedBytes += 4;
+                }
+            }
+            nullBytes = static_cast<uint16_t>((types.size() + 7) / 8);
+        }
+
+        bool empty() const { return types.empty(); }
+        size_t headerBytes() const { return fixedBytes + nullBytes + 2 * static_cast<size_t>(stringCount); }
+
+        // false if the record does not match the column types
+        bool encode(const Record& r, vector<uint8_t>& out) const {
+            if (r.fields.size() != types.size()) return false;
+            size_t header = headerBytes();
+            out.assign(header, 0);
+            for (size_t i = 0; i < types.size(); ++i) {
+                const RecordValue& v = r.fields[i];
+                if (types[i] == DataType::INT && holds_alternative<int>(v)) {
+                    int32_t x = get<int>(v);
+                    memcpy(out.data() + position[i], &x, 4);
+                } else if (types[i] == DataType::FLOAT && holds_alternative<float>(v)) {
+                    float f = get<float>(v);
+                    memcpy(out.data() + position[i], &f, 4);
+                } else if (types[i] == DataType::STRING && holds_alternative<string>(v)) {
+                    const string& str = get<string>(v);
+                    out.insert(out.end(), str.begin(), str.end());
+                    if (out.size() - header > UINT16_MAX) return false;
+                    uint16_t end = static_cast<uint16_t>(out.size() - header);
+                    memcpy(out.data() + fixedBytes + nullBytes + 2 * position[i], &end, 2);
+                } else {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Non-owning view over a serialized row. Without a layout the row is in the tagged
+    // format written by StorageEngine::serializeRecord (also used by the log and snapshots):
+    //   fieldCount:u16 | per field: tag:u8 (0 = INT, 1 = FLOAT, 2 = STRING) + value
+    //   INT/FLOAT are 4 bytes, STRING is length:u16 + bytes
+    // With a layout it is a ROW_FORMAT_FIXED row of that table (see RowLayout).
+    // Fields are decoded on demand straight from the page bytes, so filters can run
+    // without allocating; materialize() builds a Record only for rows that are kept.
+    // The view is only valid while the underlying page buffer is.
+    class RecordView {
+    public:
+        RecordView() = default;
+        RecordView(const uint8_t* bytes, size_t size, const RowLayout* rowLayout = nullptr)
+            : data(bytes), length(size), layout(rowLayout) {}
+
+        bool valid() const {
+            if (data == nullptr) return false;
+            return layout ? length >= layout->headerBytes() : length >= 2;
+        }
+
+        uint16_t fieldCount() const {
+            if (!valid()) return 0;
+            if (layout) return static_cast<uint16_t>(layout->types.size());
+            uint16_t count = 0;
+            memcpy(&count, data, 2);
+            return count;
+        }
+
+        optional<DataType> fieldType(uint16_t index) const {
+            if (layout) {
+                if (index >= fieldCount()) return nullopt;
+                return layout->types[index];
+            }
+            size_t pos = fieldOffset(index);
+            if (pos == NPOS) return nullopt;
+            return tagType(data[pos]);
+        }
+
+        optional<int> getInt(uint16_t index) const {
+            const uint8_t* p = valuePtr(index, DataType::INT, TAG_INT);
+            if (!p) return nullopt;
+            int32_t v = 0;
+            memcpy(&v, p, 4);
+            return v;
+        }
+
+        optional<float> getFloat(uint16_t index) const {
+            const uint8_t* p = valuePtr(index, DataType::FLOAT, TAG_FLOAT);
+            if (!p) return nullopt;
+            float v = 0.0f;
+            memcpy(&v, p, 4);
+            return v;
+        }
+
+        optional<string_view> getString(uint16_t index) const {
+            if (layout) {
+                size_t begin = 0, end = 0;
+                if (!fixedString(index, begin, end)) return nullopt;
+                return string_view(reinterpret_cast<const char*>(data + begin), end - begin);
+            }
+            size_t pos = fieldOffset(index);
+            if (pos == NPOS || data[pos] != TAG_STRING) return nullopt;
+            uint16_t len = 0;
+            memcpy(&len, data + pos + 1, 2);
+            return string_view(reinterpret_cast<const char*>(data + pos + 3), len);
+        }
+
+        // Decodes every field into out (false if the bytes are truncated).
+        // A NULL column of a fixed row comes out as its type's zero value.
+        bool materialize(Record& out) const {
+            out.fields.clear();
+            if (!valid()) return false;
+            uint16_t count = fieldCount();
+            out.fields.reserve(count);
+            if (layout) {
+                for (uint16_t i = 0; i < count; ++i) {
+                    DataType type = layout->types[i];
+                    if (type == DataType::STRING) {
+                        size_t begin = 0, end = 0;
+                        if (fixedString(i, begin, end))
+                            out.fields.emplace_back(string(reinterpret_cast<const char*>(data + begin), end - begin));
+                        else if (isNull(i)) out.fields.emplace_back(string());
+                        else return false;
+                    } else if (type == DataType::INT) {
+                        out.fields.emplace_back(getInt(i).value_or(0));
+                    } else {
+                        out.fields.emplace_back(getFloat(i).value_or(0.0f));
+                    }
+                }
+                return true;
+            }
+
+            size_t pos = 2;
+            for (uint16_t i = 0; i < count; ++i) {
+                size_t size = fieldSize(pos);
+                if (size == NPOS) return false;
+                if (data[pos] == TAG_INT) {
+                    int32_t v = 0; memcpy(&v, data + pos + 1, 4);
+                    out.fields.emplace_back(v);
+                } else if (data[pos] == TAG_FLOAT) {
+                    float v = 0.0f; memcpy(&v, data + pos + 1, 4);
+                    out.fields.emplace_back(v);
+                } else {
+                    out.fields.emplace_back(string(reinterpret_cast<const char*>(data + pos + 3), size - 3));
+                }
+                pos += size;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr size_t NPOS = static_cast<size_t>(-1);
+        static constexpr uint8_t TAG_INT = 0;
+        static constexpr uint8_t TAG_FLOAT = 1;
+        static constexpr uint8_t TAG_STRING = 2;
+
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        const RowLayout* layout = nullptr;
+
+        static DataType tagType(uint8_t tag) {
+            if (tag == TAG_INT) return DataType::INT;
+            if (tag == TAG_FLOAT) return DataType::FLOAT;
+            return DataType::STRING;
+        }
+
+        // --- fixed rows ---
+        bool isNull(uint16_t index) const {
+            return (data[layout->fixedBytes + index / 8] >> (index % 8)) & 1;
+        }
+
+        // Bytes of a non-NULL INT/FLOAT field (either format), nullptr if absent or of another type
+        const uint8_t* valuePtr(uint16_t index, DataType type, uint8_t tag) const {
+            if (layout) {
+                if (index >= fieldCount() || layout->types[index] != type || isNull(index)) return nullptr;
+                return data + layout->position[index];
+            }
+            size_t pos = fieldOffset(index);
+            if (pos == NPOS || data[pos] != tag) return nullptr;
+            return data + pos + 1;
+        }
+
+        // [begin, end) of a non-NULL STRING field of a fixed row
+        bool fixedString(uint16_t index, size_t& begin, size_t& end) const {
+            if (index >= fieldCount() || layout->types[index] != DataType::STRING || isNull(index)) return false;
+            const uint8_t* offsets = data + layout->fixedBytes + layout->nullBytes;
+            uint16_t slot = layout->position[index];
+            uint16_t from = 0, to = 0;
+            if (slot > 0) memcpy(&from, offsets + 2 * (slot - 1), 2);
+            memcpy(&to, offsets + 2 * slot, 2);
+            begin = layout->headerBytes() + from;
+            end = layout->headerBytes() + to;
+            return from <= to && end <= length;
+        }
+
+        // --- tagged rows ---
+        // Encoded size of the field starting at pos (tag included), NPOS if truncated
+        size_t fieldSize(size_t pos) const {
+            if (pos >= length) return NPOS;
+            size_t size;
+            if (data[pos] == TAG_INT || data[pos] == TAG_FLOAT) {
+                size = 5;
+            } else {
+                if (pos + 3 > length) return NPOS;
+                uint16_t len = 0;
+                memcpy(&len, data + pos + 1, 2);
+                size = 3 + static_cast<size_t>(len);
+            }
+            return (pos + size <= length) ? size : NPOS;
+        }
+
+        // Byte offset of field index (its tag), NPOS if out of range or truncated
+        size_t fieldOffset(uint16_t index) const {
+            if (index >= fieldCount()) return NPOS;
+            size_t pos = 2;
+            for (uint16_t i = 0; i < index; ++i) {
+                size_t size = fieldSize(pos);
+                if (size == NPOS) return NPOS;
+                pos += size;
+            }
+            return fieldSize(pos) == NPOS ? NPOS : pos;
+        }
+    };
+
+    // Single-column filter (WHERE <col> <op> <value>) evaluated while a cursor scans:
+    // on HEAP pages it reads the column through a RecordView, so rows that do not
+    // match are never materialized. A value of a different type never matches.
+    // BETWEEN is the closed range [value, high].
+    enum class CompareOp { EQ, LT, LE, GT, GE, BETWEEN };
+
+    struct ScanPredicate {
+        uint16_t column = 0;
+        CompareOp op = CompareOp::EQ;
+        RecordValue value;
+        RecordValue high; // BETWEEN only, same type as value
+
+        bool matches(const RecordView& row) const {
+            if (holds_alternative<int>(value)) {
+                auto v = row.getInt(column);
+                return v.has_value() && matchesInt(v.value());
+            }
+            if (holds_alternative<float>(value)) {
+                auto v = row.getFloat(column);
+                return v.has_value() && matchesFloat(v.value());
+            }
+            auto v = row.getString(column);
+            return v.has_value() && matchesString(v.value());
+        }
+
+        // One value of the predicate's column (e.g. from a columnar segment)
+        bool matchesInt(int v) const {
+            return holds_alternative<int>(value) && test(compare(v, get<int>(value))) &&
+                   (op != CompareOp::BETWEEN || compare(v, get<int>(high)) <= 0);
+        }
+        bool matchesFloat(float v) const {
+            return holds_alternative<float>(value) && test(compareFloat(v, get<float>(value))) &&
+                   (op != CompareOp::BETWEEN || compareFloat(v, get<float>(high)) <= 0);
+        }
+        bool matchesString(string_view v) const {
+            return holds_alternative<string>(value) && test(v.compare(get<string>(value))) &&
+                   (op != CompareOp::BETWEEN || v.compare(get<string>(high)) <= 0);
+        }
+
+        bool matches(const Record& row) const {
+            if (column >= row.fields.size() || row.fields[column].index() != value.index()) return false;
+            const RecordValue& cell = row.fields[column];
+            if (holds_alternative<int>(value)) return matchesInt(get<int>(cell));
+            if (holds_alternative<float>(value)) return matchesFloat(get<float>(cell));
+            return matchesString(get<string>(cell));
+        }
+
+        // The ids an INT predicate on column 0 allows, as the closed range [first, last]
+        // (whole INT range for any other predicate); false when no id can match.
+        // Id-ordered structures use it to seek instead of scanning.
+        bool idRange(int& first, int& last) const {
+            first = INT_MIN;
+            last = INT_MAX;
+            if (column != 0 || !holds_alternative<int>(value)) return true;
+            int v = get<int>(value);
+            switch (op) {
+                case CompareOp::EQ: first = v; last = v; break;
+                case CompareOp::LT: if (v == INT_MIN) return false; last = v - 1; break;
+                case CompareOp::LE: last = v; break;
+                case CompareOp::GT: if (v == INT_MAX) return false; first = v + 1; break;
+                case CompareOp::GE: first = v; break;
+                case CompareOp::BETWEEN: first = v; last = get<int>(high); break;
+            }
+            return first <= last;
+        }
+
+    private:
+        template <typename T>
+        static int compare(T a, T b) { return (a < b) ? -1 : (a > b ? 1 : 0); }
+        // FLOAT equality uses the same tolerance as the parser always has
+        static int compareFloat(float a, float b) { return (std::fabs(a - b) < 0.0001f) ? 0 : compare(a, b); }
+
+        bool test(int cmp) const {
+            switch (op) {
+                case CompareOp::EQ: return cmp == 0;
+                case CompareOp::LT: return cmp < 0;
+                case CompareOp::LE: return cmp <= 0;
+                case CompareOp::GT: return cmp > 0;
+                case CompareOp::GE: return cmp >= 0;
+                case CompareOp::BETWEEN: return cmp >= 0; // upper end checked by the caller
+            }
+            return false;
+        }
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_RECORD_VIEW_H
@@ -17,39 +17,149 @@ namespace ChronoDB {
         return static_cast<uint16_t>(PAGE_SIZE - usedDataBytes() - slotDirBytes);
     }
 
-    optional<uint16_t> Page::insertRawRecord(const vector<uint8_t>& rec) {
+    optional<uint16_t> Page::insertRawRecord(const vector<uint8_t>& rec, uint8_t flags) {
         uint16_t need = static_cast<uint16_t>(rec.size());
-        uint16_t slotOverhead = sizeof(SlotEntry);
+
+        // reuse the directory entry of a deleted row before growing the directory
+        uint16_t slotID = static_cast<uint16_t>(slots.size());
+        for (uint16_t i = 0; i < slots.size(); ++i)
+            if (!slots[i].active) { slotID = i; break; }
+        uint16_t slotOverhead = (slotID == slots.size()) ? sizeof(SlotEntry) : 0;
         if (freeSpace() < need + slotOverhead) return nullopt;
 
         memcpy(data.data() + freeSpaceOffset, rec.data(), need);
-        slots.emplace_back(freeSpaceOffset, need, true);
-        uint16_t slotID = static_cast<uint16_t>(slots.size() - 1);
+        if (slotID == slots.size()) slots.emplace_back(freeSpaceOffset, need, true, flags);
+        else slots[slotID] = SlotEntry(freeSpaceOffset, need, true, flags);
         freeSpaceOffset += need;
         slotCount = static_cast<uint16_t>(slots.size());
         return slotID;
     }
 
+    bool Page::replaceRecord(uint16_t slotID, const vector<uint8_t>& rec) {
+        if (slotID >= slots.size() || !slots[slotID].active) return false;
+        uint16_t need = static_cast<uint16_t>(rec.size());
+
+        // fits the existing slot: overwrite in place
+        if (need <= slots[slotID].length) {
+            memcpy(data.data() + slots[slotID].offset, rec.data(), need);
+            slots[slotID].length = need;
+            return true;
+        }
+
+        // otherwise move it to the end of the data area, compacting first if that makes room
+        if (freeSpace() < need) {
+            if (freeSpace() + deadBytes() + slots[slotID].length < need) return false;
+            slots[slotID].length = 0;
+            compact();
+        }
+        memcpy(data.data() + freeSpaceOffset, rec.data(), need);
+        slots[slotID].offset = freeSpaceOffset;
+        slots[slotID].length = need;
+        freeSpaceOffset += need;
+        return true;
+    }
+
     bool Page::deleteSlot(uint16_t slotID) {
         if (slotID >= slots.size() || !slots[slotID].active) return false;
         slots[slotID].active = false;
+        slots[slotID].flags = 0;
         return true;
     }
 
+    uint16_t Page::deadBytes() const {
+        uint32_t live = 0;
+        for (const SlotEntry& s : slots)
+            if (s.active) live += s.length;
+        uint32_t used = freeSpaceOffset - PAGE_HEADER_RESERVED;
+        return used > live ? static_cast<uint16_t>(used - live) : 0;
+    }
+
+    uint16_t Page::liveSlotCount() const {
+        uint16_t live = 0;
+        for (const SlotEntry& s : slots)
+            if (s.active) live++;
+        return live;
+    }
+
+    uint16_t Page::compact() {
+        uint16_t before = freeSpace();
+        vector<uint8_t> packed(PAGE_SIZE, 0);
+        uint16_t pos = PAGE_HEADER_RESERVED;
+        for (SlotEntry& s : slots) {
+            if (!s.active) { s.offset = 0; s.length = 0; continue; }
+            memcpy(packed.data() + pos, data.data() + s.offset, s.length);
+            s.offset = pos;
+            pos += s.length;
+        }
+        // trailing tombstones can be dropped from the slot directory entirely
+        while (!slots.empty() && !slots.back().active) slots.pop_back();
+
+        data.swap(packed);
+        freeSpaceOffset = pos;
+        slotCount = static_cast<uint16_t>(slots.size());
+        return static_cast<uint16_t>(freeSpace() - before);
+    }
+
     bool Page::readRawRecord(uint16_t slotID, vector<uint8_t>& out) const {
+        const uint8_t* ptr = nullptr;
+        uint16_t len = 0;
+        if (!recordBytes(slotID, ptr, len)) return false;
+        out.assign(ptr, ptr + len);
+        return true;
+    }
+
+    bool Page::recordBytes(uint16_t slotID, const uint8_t*& ptr, uint16_t& len) const {
         if (slotID >= slots.size() || !slots[slotID].active) return false;
         const SlotEntry& s = slots[slotID];
-        if (s.offset + s.length > PAGE_SIZE) return false;
-        out.resize(s.length);
-        memcpy(out.data(), data.data() + s.offset, s.length);
+        if (s.isForward() || s.offset + s.length > PAGE_SIZE) return false;
+        uint16_t skip = s.isMoved() ? FORWARD_STUB_BYTES : 0;
+        if (s.length < skip) return false;
+        ptr = data.data() + s.offset + skip;
+        len = s.length - skip;
+        return true;
+    }
+
+    void Page::encodeRID(const RecordID& rid, uint8_t* out) {
+        memcpy(out, &rid.pageID, 4);
+        memcpy(out + 4, &rid.slotID, 2);
+    }
+
+    RecordID Page::decodeRID(const uint8_t* in) {
+        RecordID rid{0, 0};
+        memcpy(&rid.pageID, in, 4);
+        memcpy(&rid.slotID, in + 4, 2);
+        return rid;
+    }
+
+    optional<RecordID> Page::forwardTarget(uint16_t slotID) const {
+        if (slotID >= slots.size() || !slots[slotID].active || !slots[slotID].isForward()) return nullopt;
+        return decodeRID(data.data() + slots[slotID].offset);
+    }
+
+    optional<RecordID> Page::movedFrom(uint16_t slotID) const {
+        if (slotID >= slots.size() || !slots[slotID].active || !slots[slotID].isMoved()) return nullopt;
+        return decodeRID(data.data() + slots[slotID].offset);
+    }
+
+    // Turns a live slot into a forwarding stub (the stub reuses the slot's own bytes)
+    bool Page::setForward(uint16_t slotID, const RecordID& target) {
+        if (slotID >= slots.size() || !slots[slotID].active) return false;
+        SlotEntry& s = slots[slotID];
+        if (s.length < FORWARD_STUB_BYTES) return false;
+        encodeRID(target, data.data() + s.offset);
+        s.length = FORWARD_STUB_BYTES;
+        s.flags = SLOT_FORWARD;
         return true;
     }
 
     void Page::serializeToBuffer(vector<uint8_t>& buffer) const {
         buffer.assign(PAGE_SIZE, 0);
         memcpy(buffer.data(), &pageID, sizeof(pageID));
+        memcpy(buffer.data() + 4, &link, sizeof(link));
         memcpy(buffer.data() + 8, &slotCount, sizeof(slotCount));
         memcpy(buffer.data() + 10, &freeSpaceOffset, sizeof(freeSpaceOffset));
+        buffer[12] = rowFormat;
+        buffer[13] = kind;
         if (freeSpaceOffset > PAGE_HEADER_RESERVED)
             memcpy(buffer.data() + PAGE_HEADER_RESERVED, data.data() + PAGE_HEADER_RESERVED, freeSpaceOffset - PAGE_HEADER_RESERVED);
 
@@ -57,7 +167,7 @@ namespace ChronoDB {
         for (int i = static_cast<int>(slots.size()) - 1; i >= 0; --i) {
             const SlotEntry& s = slots[i];
             pos -= 5;
-            buffer[pos] = s.active ? 1 : 0;
+            buffer[pos] = static_cast<uint8_t>((s.active ? 1 : 0) | s.flags);
             memcpy(buffer.data() + pos + 1, &s.length, 2);
             memcpy(buffer.data() + pos + 3, &s.offset, 2);
         }
@@ -66,8 +176,11 @@ namespace ChronoDB {
     void Page::deserializeFromBuffer(const vector<uint8_t>& buffer) {
         if (buffer.size() < PAGE_SIZE) return;
         memcpy(&pageID, buffer.data(), sizeof(pageID));
+        memcpy(&link, buffer.data() + 4, sizeof(link));
         memcpy(&slotCount, buffer.data() + 8, sizeof(slotCount));
         memcpy(&freeSpaceOffset, buffer.data() + 10, sizeof(freeSpaceOffset));
+        rowFormat = buffer[12];
+        kind = buffer[13];
 
         if (freeSpaceOffset > PAGE_HEADER_RESERVED)
             memcpy(data.data() + PAGE_HEADER_RESERVED, buffer.data() + PAGE_HEADER_RESERVED, freeSpaceOffset - PAGE_HEADER_RESERVED);
@@ -77,23 +190,165 @@ namespace ChronoDB {
         for (uint16_t i = 0; i < slotCount; ++i) {
             if (pos < 5) break;
             pos -= 5;
-            bool active = buffer[pos] != 0;
+            bool active = (buffer[pos] & 0x01) != 0;
+            uint8_t flags = buffer[pos] & (SLOT_FORWARD | SLOT_MOVED);
             uint16_t len = 0, off = 0;
             memcpy(&len, buffer.data() + pos + 1, 2);
             memcpy(&off, buffer.data() + pos + 3, 2);
-            slots.emplace_back(off, len, active);
+            slots.emplace_back(off, len, active, flags);
         }
         reverse(slots.begin(), slots.end());
     }
 
+    // ---------- PageView ----------
+    uint16_t PageView::slotCount() const {
+        uint16_t count = 0;
+        memcpy(&count, bytes + 8, sizeof(count));
+        return min<uint16_t>(count, (PAGE_SIZE - PAGE_HEADER_RESERVED) / 5);
+    }
+
+    // slot i is stored i entries back from the end of the page
+    SlotEntry PageView::slot(uint16_t slotID) const {
+        const uint8_t* entry = bytes + PAGE_SIZE - 5 * (static_cast<size_t>(slotID) + 1);
+        uint16_t len = 0, off = 0;
+        memcpy(&len, entry + 1, 2);
+        memcpy(&off, entry + 3, 2);
+        return SlotEntry(off, len, (entry[0] & 0x01) != 0, entry[0] & (SLOT_FORWARD | SLOT_MOVED));
+    }
+
+    bool PageView::recordBytes(uint16_t slotID, const uint8_t*& ptr, uint16_t& len) const {
+        if (slotID >= slotCount()) return false;
+        SlotEntry s = slot(slotID);
+        if (!s.active || s.isForward() || s.offset + s.length > PAGE_SIZE) return false;
+        uint16_t skip = s.isMoved() ? FORWARD_STUB_BYTES : 0;
+        if (s.length < skip) return false;
+        ptr = bytes + s.offset + skip;
+        len = s.length - skip;
+        return true;
+    }
+
     // ---------- StorageEngine ----------
-    StorageEngine::StorageEngine(const string& storageDir) : storageDirectory(storageDir) {
+    StorageEngine::StorageEngine(const string& storageDir, size_t bufferPoolBytes)
+        : storageDirectory(storageDir), bufferPool(bufferPoolBytes), wal(storageDir + "/chronodb.wal") {
         if (!fs::exists(storageDirectory))
             fs::create_directories(storageDirectory);
-        // (In a real system we would load the 'tableStructures' registry from disk here)
+
+        // pages only reach disk at checkpoints (double-write + in place); the log covers the rest
+        bufferPool.setNoSteal(true);
+        bufferPool.setBeforeWriteHook([this]() { wal.commit(); });
+
+        // 1. finish a checkpoint that was interrupted while writing pages in place
+        optional<uint64_t> pagesLSN = BufferPool::recoverDoubleWrite(doubleWritePath());
+
+        // 2. Rebuild the 'tableStructures' registry from the catalog and restore each table:
+        // HEAP tables load (or rebuild) their primary-key index, in-memory structures
+        // bulk-load their last snapshot
+        unordered_map<string, uint64_t> appliedLSN;
+        loadCatalog();
+        for (const auto& [name, entry] : catalog) {
+            tableStructures[name] = entry.structure;
+            switch (entry.structure) {
+                case StructureType::AVL:  avlTables[name];  loadSnapshot(name, appliedLSN[name]); break;
+                case StructureType::BST:  bstTables[name];  loadSnapshot(name, appliedLSN[name]); break;
+                case StructureType::HASH: hashTables[name]; loadSnapshot(name, appliedLSN[name]); break;
+                case StructureType::COLUMNAR: loadSnapshot(name, appliedLSN[name]); break;
+                case StructureType::BTREE: btreeFor(name).open(); break; // pages: redone from heapLSN
+                case StructureType::HEAP:
+                default:
+                    if (fs::exists(tableDataPath(name))) {
+                        indexFor(name);
+                        freeSpaceFor(name);
+                        zoneMapFor(name);
+                    }
+                    break;
+            }
+        }
+
+        // 3. redo every committed statement newer than the state each table was restored to
+        vector<WalRecord> records;
+        wal.open(records);
+        uint64_t heapLSN = pagesLSN.value_or(wal.baseLSN() - 1);
+        replaying = true;
+        for (const WalRecord& r : records) {
+            auto it = appliedLSN.find(r.table);
+            uint64_t applied = (it != appliedLSN.end()) ? it->second : heapLSN;
+            if (r.lsn <= applied || !findTable(r.table)) continue;
+
+            Record row;
+            if (!r.row.empty()) deserializeRecord(r.row, row);
+            if (r.op == WalOp::INSERT) applyInsert(r.table, row);
+            else if (r.op == WalOp::UPDATE) applyUpdate(r.table, r.id, row);
+            else if (r.op == WalOp::DELETE) applyDelete(r.table, r.id);
+        }
+        replaying = false;
+
+        if (!records.empty() || pagesLSN.has_value()) checkpoint();
+    }
+
+    StorageEngine::~StorageEngine() {
+        checkpoint();
+    }
+
+    // Checkpoint: force the log, write dirty pages through the double-write buffer,
+    // snapshot the in-memory structures and index files, then truncate the log.
+    // A crash at any step leaves either the old or the new state plus a log to redo.
+    void StorageEngine::checkpoint() {
+        if (!wal.commit()) return;
+        uint64_t lsn = wal.lastLSN();
+
+        if (!bufferPool.flushAllAtomic(doubleWritePath(), lsn)) return;
+        for (auto& [name, idx] : primaryIndexes)
+            if (idx.isDirty()) idx.checkpoint();
+        for (auto& [name, fsm] : freeSpaceMaps)
+            if (fsm.isDirty()) fsm.checkpoint();
+        for (auto& [name, zones] : zoneMaps)
+            if (zones.isDirty()) zones.checkpoint();
+        for (const string& name : dirtySnapshots)
+            if (!writeSnapshot(name, lsn)) return;
+        dirtySnapshots.clear();
+
+        wal.reset(lsn + 1);
+        error_code ec;
+        fs::remove(doubleWritePath(), ec);
+    }
+
+    // --- Write-ahead logging ---
+    void StorageEngine::beginBatch() {
+        batchDepth++;
+    }
+
+    bool StorageEngine::commitBatch() {
+        if (batchDepth > 0) batchDepth--;
+        if (batchDepth > 0) return true;
+        return wal.commit();
     }
 
-    StorageEngine::~StorageEngine() {}
+    // Logs a statement that has just been applied. Outside a batch the record is made
+    // durable right away (false if that fails); inside one it waits for commitBatch()
+    // (one fsync for all)
+    bool StorageEngine::logWrite(WalOp op, const string& tableName, int id, const vector<uint8_t>& row) {
+        if (replaying) return true;
+        wal.append(op, tableName, id, row);
+        if (batchDepth == 0 && !wal.commit()) return false;
+
+        // lazy checkpoint: once the pool is mostly dirty pages or the log has grown large
+        if (bufferPool.dirtyCount() * 4 >= bufferPool.frameCount() * 3 || wal.sizeBytes() >= WAL_CHECKPOINT_BYTES)
+            checkpoint();
+        return true;
+    }
+
+    // Row image for the log; false if it or the table name does not fit a log record. A
+    // string's length is a u16 in the row format, so a longer one can never fit either.
+    bool StorageEngine::serializeForLog(const string& tableName, const Record& rec, vector<uint8_t>& row) {
+        for (const RecordValue& v : rec.fields)
+            if (holds_alternative<string>(v) && get<string>(v).size() > WriteAheadLog::MAX_ROW_BYTES) return false;
+        serializeRecord(rec, row);
+        return WriteAheadLog::fits(tableName, row);
+    }
+
+    string StorageEngine::doubleWritePath() const {
+        return storageDirectory + "/chronodb.dwb";
+    }
 
     string StorageEngine::tableDataPath(const string& tableName) const {
         return storageDirectory + "/" + tableName + ".tbl";
@@ -103,6 +358,26 @@ namespace ChronoDB {
         return storageDirectory + "/" + tableName + ".meta";
     }
 
+    string StorageEngine::tableIndexPath(const string& tableName) const {
+        return storageDirectory + "/" + tableName + ".idx";
+    }
+
+    string StorageEngine::tableFreeSpacePath(const string& tableName) const {
+        return storageDirectory + "/" + tableName + ".fsm";
+    }
+
+    string StorageEngine::tableZoneMapPath(const string& tableName) const {
+        return storageDirectory + "/" + tableName + ".zmap";
+    }
+
+    string StorageEngine::tableSnapshotPath(const string& tableName) const {
+        return storageDirectory + "/" + tableName + ".snap";
+    }
+
+    string StorageEngine::tableBTreePath(const string& tableName) const {
+        return storageDirectory + "/" + tableName + ".btree";
+    }
+
     // New createTable with columns (writes meta + empty tbl)
 
     // Backwards-compatible createTable that writes an empty table with no meta
@@ -114,40 +389,55 @@ namespace ChronoDB {
         return createTable(tableName, columns, "HEAP");
     }
 
-    bool StorageEngine::createTable(const string& tableName, const vector<Column>& columns, const string& structureType) {
-        // 1. Check if already exists in memory registry
+    bool StorageEngine::createTable(const string& tableName, const vector<Column>& columns, const string& structureType,
+                                    bool compressed) {
+        // 1. Check if already exists in memory registry / catalog
         if (tableStructures.find(tableName) != tableStructures.end()) return false;
+        if (findTable(tableName)) return false;
 
         // 2. Register type
-        if (structureType == "AVL") {
-            tableStructures[tableName] = StructureType::AVL;
+        StructureType type = parseStructureType(structureType);
+        if (compressed && type != StructureType::COLUMNAR) return false;
+        // BTREE: keyed by the first column, which must be INT
+        if (type == StructureType::BTREE && (columns.empty() || parseDataType(columns[0].type) != DataType::INT))
+            return false;
+        tableStructures[tableName] = type;
+        if (type == StructureType::AVL) {
             avlTables[tableName] = AVLTree(); 
-        } else if (structureType == "BST") {
-            tableStructures[tableName] = StructureType::BST;
+        } else if (type == StructureType::BST) {
             bstTables[tableName] = BST();
-        } else if (structureType == "HASH") {
-            tableStructures[tableName] = StructureType::HASH;
+        } else if (type == StructureType::HASH) {
             hashTables[tableName] = HashTable();
-        } else {
-            tableStructures[tableName] = StructureType::HEAP;
         }
+        bool columnar = type == StructureType::COLUMNAR;
 
-        // 3. Persist metadata (schema) to disk regardless of structure
+        // 3. Persist metadata (schema + structure type) to disk regardless of structure
         // This allows us to know columns even if data is in memory
-        if (readMetaFile(tableName).has_value()) return false; 
-        
         // Write meta file (if columns provided)
         if (!columns.empty()) {
-             if (!writeMetaFile(tableName, columns)) return false;
+             if (!writeMetaFile(tableName, columns, type, compressed)) return false;
         } else {
              // For legacy empty create
              vector<Column> cols;
-             writeMetaFile(tableName, cols);
+             writeMetaFile(tableName, cols, type);
+        }
+
+        // COLUMNAR: empty segment files and manifest (needs the catalog entry for the types)
+        if (columnar) {
+             columnStores.erase(tableName);
+             if (!columnStoreFor(tableName).create()) return false;
+        }
+
+        // BTREE: meta page + empty root leaf
+        if (type == StructureType::BTREE) {
+             btreeTables.erase(tableName);
+             if (!btreeFor(tableName).create()) return false;
         }
 
         // 4. If HEAP, create the empty page file
         if (tableStructures[tableName] == StructureType::HEAP) {
              string path = tableDataPath(tableName);
+             bufferPool.discardFile(path);
              ofstream file(path, ios::binary);
              if (!file) return false;
              // Write standard empty page
@@ -157,6 +447,15 @@ namespace ChronoDB {
              p.serializeToBuffer(buffer);
              file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
              file.close();
+
+             primaryIndexes[tableName] = PrimaryIndex(tableIndexPath(tableName));
+             primaryIndexes[tableName].checkpoint();
+             freeSpaceMaps[tableName] = FreeSpaceMap(tableFreeSpacePath(tableName));
+             freeSpaceMaps[tableName].reset({p.freeSpace()});
+             freeSpaceMaps[tableName].checkpoint();
+             zoneMaps[tableName] = ZoneMap(tableZoneMapPath(tableName), findTable(tableName)->types);
+             zoneMaps[tableName].update(0, p, nullptr);
+             zoneMaps[tableName].checkpoint();
         }
 
         return true;
@@ -180,27 +479,40 @@ namespace ChronoDB {
         p.serializeToBuffer(buffer);
         out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
         out.close();
+        freeSpaceFor(tableName).update(p.pageID, p.freeSpace());
+        zoneMapFor(tableName).update(p.pageID, p, nullptr);
         return p.pageID;
     }
 
-    bool StorageEngine::writePageToFile(const string& tableName, uint32_t pageIndex, const Page& page) {
-        fstream fsout(tableDataPath(tableName), ios::binary | ios::in | ios::out);
-        if (!fsout) { fsout.open(tableDataPath(tableName), ios::binary | ios::out); fsout.close(); fsout.open(tableDataPath(tableName), ios::binary | ios::in | ios::out); }
-        vector<uint8_t> buffer;
-        page.serializeToBuffer(buffer);
-        fsout.seekp(static_cast<streampos>(pageIndex) * PAGE_SIZE);
-        fsout.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
-        fsout.flush(); fsout.close();
+    // Page I/O goes through the buffer pool: reads hit cached frames, writes mark them dirty
+    bool StorageEngine::writePageToFile(const string& tableName, uint32_t pageIndex, const Page& page, int appendedSlot) {
+        string path = tableDataPath(tableName);
+        // every frame pinned: the page is not written (pages reach the file only at a
+        // checkpoint, after the log records that describe them)
+        Page* frame = bufferPool.pinPage(path, pageIndex, false);
+        if (!frame) return false;
+        *frame = page;
+        bufferPool.unpinPage(path, pageIndex, true);
+        freeSpaceFor(tableName).update(pageIndex, page.freeSpace() + page.deadBytes());
+        const RowLayout* layout = layoutFor(tableName, page.rowFormat);
+        if (appendedSlot >= 0) zoneMapFor(tableName).widen(pageIndex, page, static_cast<uint16_t>(appendedSlot), layout);
+        else zoneMapFor(tableName).update(pageIndex, page, layout);
         return true;
     }
 
-    bool StorageEngine::readPageFromFile(const string& tableName, uint32_t pageIndex, Page& outPage) {
-        ifstream infile(tableDataPath(tableName), ios::binary);
-        infile.seekg(static_cast<streampos>(pageIndex) * PAGE_SIZE);
-        vector<uint8_t> buffer(PAGE_SIZE);
-        infile.read(reinterpret_cast<char*>(buffer.data()), PAGE_SIZE);
-        infile.close();
-        outPage.deserializeFromBuffer(buffer);
+    bool StorageEngine::readPageFromFile(const string& tableName, uint32_t pageIndex, Page& outPage) const {
+        string path = tableDataPath(tableName);
+        Page* frame = bufferPool.pinPage(path, pageIndex);
+        if (!frame) {
+            ifstream infile(path, ios::binary);
+            infile.seekg(static_cast<streampos>(pageIndex) * PAGE_SIZE);
+            vector<uint8_t> buffer(PAGE_SIZE);
+            infile.read(reinterpret_cast<char*>(buffer.data()), PAGE_SIZE);
+            outPage.deserializeFromBuffer(buffer);
+            return true;
+        }
+        outPage = *frame;
+        bufferPool.unpinPage(path, pageIndex, false);
         return true;
     }
 
@@ -237,265 +549,762 @@ namespace ChronoDB {
     }
 
     bool StorageEngine::deserializeRecord(const vector<uint8_t>& in, Record& out) {
-        out.fields.clear();
-        if (in.size() < 2) return false;
-        uint16_t fieldCount = 0; memcpy(&fieldCount, in.data(), 2);
-        size_t pos = 2;
-
-        for (uint16_t i = 0; i < fieldCount; ++i) {
-            if (pos >= in.size()) return false;
-            uint8_t typeTag = in[pos]; pos += 1;
-            if (typeTag == 0) {
-                if (pos + 4 > in.size()) return false;
-                int32_t x; memcpy(&x, in.data() + pos, 4); pos += 4;
-                out.fields.emplace_back(x);
-            } else if (typeTag == 1) {
-                if (pos + 4 > in.size()) return false;
-                float f; memcpy(&f, in.data() + pos, 4); pos += 4;
-                out.fields.emplace_back(f);
-            } else {
-                if (pos + 2 > in.size()) return false;
-                uint16_t len = 0; memcpy(&len, in.data() + pos, 2); pos += 2;
-                if (pos + len > in.size()) return false;
-                string s(reinterpret_cast<const char*>(in.data() + pos), len);
-                pos += len;
-                out.fields.emplace_back(s);
-            }
-        }
-        return true;
+        return deserializeRecord(in.data(), in.size(), out);
     }
 
-    // helper: check a schema type string matches a RecordValue
-    bool StorageEngine::typeStringMatchesValue(const string& typeStr, const RecordValue& v) {
+    bool StorageEngine::deserializeRecord(const uint8_t* in, size_t size, Record& out) {
+        return RecordView(in, size).materialize(out);
+    }
+
+    // helper: resolve a schema type string once (catalog load / create)
+    DataType StorageEngine::parseDataType(const string& typeStr) {
         string t = typeStr;
         transform(t.begin(), t.end(), t.begin(), ::toupper);
-        if (t == "INT") return holds_alternative<int>(v);
-        if (t == "FLOAT") return holds_alternative<float>(v);
-        if (t == "STRING") return holds_alternative<string>(v);
+        if (t == "INT") return DataType::INT;
+        if (t == "FLOAT") return DataType::FLOAT;
+        return DataType::STRING;
+    }
+
+    StorageEngine::StructureType StorageEngine::parseStructureType(const string& typeStr) {
+        if (typeStr == "AVL") return StructureType::AVL;
+        if (typeStr == "BST") return StructureType::BST;
+        if (typeStr == "HASH") return StructureType::HASH;
+        if (typeStr == "COLUMNAR") return StructureType::COLUMNAR;
+        if (typeStr == "BTREE") return StructureType::BTREE;
+        return StructureType::HEAP;
+    }
+
+    string StorageEngine::structureTypeName(StructureType type) {
+        switch (type) {
+            case StructureType::AVL: return "AVL";
+            case StructureType::BST: return "BST";
+            case StructureType::HASH: return "HASH";
+            case StructureType::COLUMNAR: return "COLUMNAR";
+            case StructureType::BTREE: return "BTREE";
+            case StructureType::HEAP: return "HEAP";
+        }
+        return "HEAP";
+    }
+
+    // helper: check a resolved column type matches a RecordValue
+    bool StorageEngine::valueMatchesType(DataType type, const RecordValue& v) {
+        switch (type) {
+            case DataType::INT: return holds_alternative<int>(v);
+            case DataType::FLOAT: return holds_alternative<float>(v);
+            case DataType::STRING: return holds_alternative<string>(v);
+        }
         return false;
     }
 
+    // helper: field count + per-column type check against the cached schema
+    bool StorageEngine::recordMatchesSchema(const CatalogEntry& table, const Record& rec) {
+        if (table.types.empty()) return true; // legacy table without columns: accept any
+        if (rec.fields.size() != table.types.size()) return false;
+        for (size_t i = 0; i < table.types.size(); ++i) {
+            if (!valueMatchesType(table.types[i], rec.fields[i])) return false;
+        }
+        return true;
+    }
+
+    // --- HEAP row format ---
+    // Tables with columns store fixed-layout rows; schema-less tables keep tagged rows
+    uint8_t StorageEngine::rowFormatOf(const CatalogEntry& table) {
+        return table.layout.empty() ? ROW_FORMAT_TAGGED : ROW_FORMAT_FIXED;
+    }
+
+    bool StorageEngine::encodeRow(const CatalogEntry& table, const Record& rec, vector<uint8_t>& out) {
+        if (table.layout.empty()) {
+            serializeRecord(rec, out);
+            return true;
+        }
+        return table.layout.encode(rec, out);
+    }
+
+    // Layout to decode the rows of a page with (nullptr: tagged rows)
+    const RowLayout* StorageEngine::layoutFor(const string& tableName, uint8_t rowFormat) const {
+        if (rowFormat != ROW_FORMAT_FIXED) return nullptr;
+        const CatalogEntry* table = findTable(tableName);
+        return (table && !table->layout.empty()) ? &table->layout : nullptr;
+    }
+
+    // Rewrites a page of tagged rows in the table's row format. Slot ids, forwarding stubs
+    // and home RIDs are kept, so the index stays valid; rows only get shorter, so they
+    // always fit. Done before new row bytes go into a page (lazy migration) and by VACUUM.
+    bool StorageEngine::upgradePage(const CatalogEntry& table, Page& p) {
+        if (p.rowFormat == rowFormatOf(table)) return true;
+        if (p.rowFormat != ROW_FORMAT_TAGGED) return false;
+
+        vector<uint8_t> packed(PAGE_SIZE, 0);
+        vector<SlotEntry> slots = p.slots;
+        uint16_t pos = PAGE_HEADER_RESERVED;
+        vector<uint8_t> bytes, row;
+        Record rec;
+        for (uint16_t i = 0; i < slots.size(); ++i) {
+            SlotEntry& s = slots[i];
+            if (!s.active) { s.offset = 0; s.length = 0; continue; }
+
+            // forwarding stubs and the home RID in front of moved rows are copied as is
+            size_t keep = (s.isForward() || s.isMoved()) ? FORWARD_STUB_BYTES : 0;
+            if (s.length < keep || s.offset + s.length > PAGE_SIZE) return false;
+            bytes.assign(p.data.begin() + s.offset, p.data.begin() + s.offset + keep);
+            if (!s.isForward()) {
+                const uint8_t* ptr = nullptr;
+                uint16_t len = 0;
+                if (!p.recordBytes(i, ptr, len) || !RecordView(ptr, len).materialize(rec)) return false;
+                if (!table.layout.encode(rec, row)) return false;
+                bytes.insert(bytes.end(), row.begin(), row.end());
+            }
+            if (pos + bytes.size() > PAGE_SIZE) return false;
+            memcpy(packed.data() + pos, bytes.data(), bytes.size());
+            s.offset = pos;
+            s.length = static_cast<uint16_t>(bytes.size());
+            pos += s.length;
+        }
+
+        p.data.swap(packed);
+        p.slots = move(slots);
+        p.freeSpaceOffset = pos;
+        p.rowFormat = ROW_FORMAT_FIXED;
+        return true;
+    }
+
+    // A row or table name the log record has no room for is refused before it is applied
     bool StorageEngine::insertRecord(const string& tableName, const Record& rec) {
+        vector<uint8_t> row;
+        if (!serializeForLog(tableName, rec, row)) return false;
+        if (!applyInsert(tableName, rec)) return false;
+        int id = (!rec.fields.empty() && holds_alternative<int>(rec.fields[0])) ? get<int>(rec.fields[0]) : 0;
+        return logWrite(WalOp::INSERT, tableName, id, row);
+    }
+
+    bool StorageEngine::updateRecord(const string& tableName, int id, const Record& newRecord) {
+        vector<uint8_t> row;
+        if (!serializeForLog(tableName, newRecord, row)) return false;
+        if (!applyUpdate(tableName, id, newRecord)) return false;
+        return logWrite(WalOp::UPDATE, tableName, id, row);
+    }
+
+    bool StorageEngine::deleteRecord(const string& tableName, int id) {
+        if (!WriteAheadLog::fits(tableName, {})) return false;
+        if (!applyDelete(tableName, id)) return false;
+        return logWrite(WalOp::DELETE, tableName, id, {});
+    }
+
+    bool StorageEngine::applyInsert(const string& tableName, const Record& rec) {
+        const CatalogEntry* table = findTable(tableName);
+        if (!table) return false;
         if (tableStructures.find(tableName) == tableStructures.end()) {
-             // Try to load from disk if not in memory (legacy support)
-             if (readMetaFile(tableName).has_value()) {
-                 tableStructures[tableName] = StructureType::HEAP;
-             } else {
-                 return false;
-             }
+             // Known from disk but not created in this session (legacy support)
+             tableStructures[tableName] = StructureType::HEAP;
         }
 
         switch (tableStructures[tableName]) {
             case StructureType::AVL:
                 avlTables[tableName].insert(rec);
+                dirtySnapshots.insert(tableName);
                 return true;
             case StructureType::BST:
                 bstTables[tableName].insert(rec);
+                dirtySnapshots.insert(tableName);
                 return true;
             case StructureType::HASH:
-                hashTables[tableName].insert(rec);
+                hashTables[tableName].upsert(rec); // an existing id is replaced, as on HEAP
+                dirtySnapshots.insert(tableName);
                 return true;
+            case StructureType::COLUMNAR:
+                // append-only: every field is stored, so the row must match the schema exactly
+                if (table->types.empty() || !recordMatchesSchema(*table, rec)) return false;
+                columnStoreFor(tableName).append(rec);
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::BTREE: {
+                // same fixed-layout row bytes as HEAP pages; an existing id is replaced
+                if (!recordMatchesSchema(*table, rec)) return false;
+                vector<uint8_t> bytes;
+                if (!encodeRow(*table, rec, bytes)) return false;
+                return btreeFor(tableName).insert(get<int>(rec.fields[0]), bytes);
+            }
             case StructureType::HEAP:
             default:
                 // Original Heap Logic
-                // validate schema matches
-                auto colsOpt = readMetaFile(tableName);
-                if (!colsOpt.has_value()) return false;
-                vector<Column> cols = colsOpt.value();
-
-                if (cols.empty()) {
-                    // fallback: accept any (legacy)
-                } else {
-                    if (rec.fields.size() != cols.size()) return false;
+                // validate schema matches (cached, pre-resolved column types)
+                if (!table->types.empty()) {
                     // require first column is int (primary key)
-                    if (!holds_alternative<int>(rec.fields[0])) return false;
-                    // types match
-                    for (size_t i = 0; i < cols.size(); ++i) {
-                        if (!typeStringMatchesValue(cols[i].type, rec.fields[i])) return false;
-                    }
+                    if (rec.fields.empty() || !holds_alternative<int>(rec.fields[0])) return false;
+                    if (!recordMatchesSchema(*table, rec)) return false;
                 }
 
-                // load all records, remove existing with same id (upsert behaviour)
-                vector<Record> records = loadAllRecords(tableName);
-                if (rec.fields.size() > 0 && holds_alternative<int>(rec.fields[0])) {
-                    int id = get<int>(rec.fields[0]);
-                    records.erase(
-                        remove_if(records.begin(), records.end(),
-                            [&](const Record& r){ return get<int>(r.fields[0]) == id; }),
-                        records.end()
-                    );
-                }
+                vector<uint8_t> bytes;
+                if (!encodeRow(*table, rec, bytes)) return false;
 
-                records.push_back(rec);
+                bool hasKey = rec.fields.size() > 0 && holds_alternative<int>(rec.fields[0]);
+                optional<RecordID> existing;
+                if (hasKey) existing = findRecordLocation(tableName, get<int>(rec.fields[0]));
 
-                // write all records back (pack into pages)
-                ofstream out(tableDataPath(tableName), ios::binary | ios::trunc);
-                if (!out) return false;
+                // append into the last page (or a fresh one), writing only that page
+                auto rid = appendRecordBytes(tableName, bytes);
+                if (!rid.has_value()) return false;
 
-                Page p;
-                p.pageID = 0;
-                for (const auto& r : records) {
-                    vector<uint8_t> bytes;
-                    serializeRecord(r, bytes);
-                    auto optSlot = p.insertRawRecord(bytes);
-                    if (!optSlot.has_value()) {
-                        vector<uint8_t> buffer; p.serializeToBuffer(buffer);
-                        out.write((char*)buffer.data(), buffer.size());
-                        p = Page(); p.pageID++;
-                        p.insertRawRecord(bytes);
-                    }
+                // upsert behaviour: the row with the same id (if any) is tombstoned only once
+                // the new one is stored, so a failed append leaves it untouched
+                if (existing.has_value() && !tombstoneRecord(tableName, existing.value())) {
+                    tombstoneRecord(tableName, rid.value());
+                    return false;
                 }
-                vector<uint8_t> buffer; p.serializeToBuffer(buffer);
-                out.write((char*)buffer.data(), buffer.size());
-                out.close();
+                if (hasKey) indexFor(tableName).put(get<int>(rec.fields[0]), rid.value());
                 return true;
         }
     }
 
-    bool StorageEngine::updateRecord(const string& tableName, int id, const Record& newRecord) {
-        auto colsOpt = readMetaFile(tableName);
-        if (!colsOpt.has_value()) return false;
-        vector<Column> cols = colsOpt.value();
-
-        if (!cols.empty()) {
-            if (newRecord.fields.size() != cols.size()) return false;
-            // types match
-            for (size_t i = 0; i < cols.size(); ++i) {
-                if (!typeStringMatchesValue(cols[i].type, newRecord.fields[i])) return false;
+    bool StorageEngine::applyUpdate(const string& tableName, int id, const Record& newRecord) {
+        const CatalogEntry* table = findTable(tableName);
+        if (!table) return false;
+        if (!recordMatchesSchema(*table, newRecord)) return false;
+
+        // in-memory structures update in place (a key change moves the row unless the new id is taken)
+        switch (getStructureType(tableName)) {
+            case StructureType::AVL:
+                if (!avlTables[tableName].update(id, newRecord)) return false;
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::BST:
+                if (!bstTables[tableName].update(id, newRecord)) return false;
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::HASH:
+                if (!hashTables[tableName].update(id, newRecord)) return false;
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::COLUMNAR:
+                return false; // append-only
+            case StructureType::BTREE: {
+                // a key change moves the row, unless the new id is taken: the new key goes in
+                // first, so a failed insert leaves the old row where it was
+                BPlusTree& tree = btreeFor(tableName);
+                int newID = get<int>(newRecord.fields[0]);
+                vector<uint8_t> bytes, existing;
+                if (!tree.find(id, existing)) return false;
+                if (newID != id && tree.find(newID, existing)) return false;
+                if (!encodeRow(*table, newRecord, bytes)) return false;
+                if (!tree.insert(newID, bytes)) return false;
+                if (newID == id || tree.erase(id)) return true;
+                tree.erase(newID); // could not remove the old key: take the copy back out
+                return false;
             }
+            case StructureType::HEAP:
+            default:
+                break;
         }
 
-        vector<Record> records = loadAllRecords(tableName);
-        bool updated = false;
-        for (auto& r : records) {
-            if (get<int>(r.fields[0]) == id) { r = newRecord; updated = true; break; }
+        auto loc = findRecordLocation(tableName, id);
+        if (!loc.has_value()) return false;
+
+        // changing the primary key must not collide with another row
+        PrimaryIndex& idx = indexFor(tableName);
+        int newID = id;
+        if (!newRecord.fields.empty() && holds_alternative<int>(newRecord.fields[0])) newID = get<int>(newRecord.fields[0]);
+        if (newID != id && idx.find(newID).has_value()) return false;
+        RecordID home = idx.find(id).value_or(loc.value());
+
+        vector<uint8_t> bytes;
+        if (!encodeRow(*table, newRecord, bytes)) return false;
+        if (!rewriteRecord(tableName, loc.value(), bytes)) return false;
+
+        // the home RID survives moves (forwarding stub), so only a key change touches the index
+        if (newID != id) {
+            idx.erase(id);
+            idx.put(newID, home);
         }
-        if (!updated) return false;
+        return true;
+    }
 
-        // write back
-        ofstream out(tableDataPath(tableName), ios::binary | ios::trunc);
-        if (!out) return false;
+    // Replaces the row stored at rid. The row stays in its slot when the new bytes fit
+    // the page; otherwise it moves to a page with room and its home slot becomes a
+    // forwarding stub, so readers holding the home RID still find it.
+    bool StorageEngine::rewriteRecord(const string& tableName, const RecordID& rid, const vector<uint8_t>& bytes) {
+        Page p;
+        readPageFromFile(tableName, rid.pageID, p);
+        if (rid.slotID >= p.slots.size() || !p.slots[rid.slotID].active) return false;
+
+        optional<RecordID> home = p.movedFrom(rid.slotID);
+        RecordID homeRID = home.value_or(rid);
+
+        // moved rows keep their home RID in front of the row bytes
+        vector<uint8_t> payload(FORWARD_STUB_BYTES);
+        Page::encodeRID(homeRID, payload.data());
+        payload.insert(payload.end(), bytes.begin(), bytes.end());
+
+        // 1. same page (in place, or elsewhere in the page under the same slot id);
+        // the bytes are in the table's row format, so the page is converted first
+        const CatalogEntry* table = findTable(tableName);
+        if (table && upgradePage(*table, p) && p.replaceRecord(rid.slotID, home.has_value() ? payload : bytes))
+            return writePageToFile(tableName, rid.pageID, p);
+
+        // 2. does not fit: move it and leave a forwarding stub in the home slot
+        if (!home.has_value() && p.slots[rid.slotID].length < FORWARD_STUB_BYTES) return false;
+
+        auto newRID = appendRecordBytes(tableName, payload, SLOT_MOVED);
+        if (!newRID.has_value()) return false;
+
+        Page homePage;
+        readPageFromFile(tableName, homeRID.pageID, homePage);
+        if (home.has_value()) {
+            // home slot is already a stub: just repoint it
+            Page::encodeRID(newRID.value(), homePage.data.data() + homePage.slots[homeRID.slotID].offset);
+        } else {
+            homePage.setForward(homeRID.slotID, newRID.value());
+        }
+        if (!writePageToFile(tableName, homeRID.pageID, homePage)) return false;
+
+        // a previously moved row leaves its old location dead (no forwarding chains)
+        if (home.has_value()) {
+            Page old;
+            readPageFromFile(tableName, rid.pageID, old);
+            old.deleteSlot(rid.slotID);
+            if (old.deadBytes() >= PAGE_COMPACT_THRESHOLD) old.compact();
+            if (!writePageToFile(tableName, rid.pageID, old)) return false;
+        }
+        return true;
+    }
 
+    bool StorageEngine::applyDelete(const string& tableName, int id) {
+        switch (getStructureType(tableName)) {
+            case StructureType::AVL:
+                if (!avlTables[tableName].erase(id)) return false;
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::BST:
+                if (!bstTables[tableName].erase(id)) return false;
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::HASH:
+                if (!hashTables[tableName].erase(id)) return false;
+                dirtySnapshots.insert(tableName);
+                return true;
+            case StructureType::COLUMNAR:
+                return false; // append-only
+            case StructureType::BTREE:
+                return btreeFor(tableName).erase(id);
+            case StructureType::HEAP:
+            default:
+                break;
+        }
+
+        auto loc = findRecordLocation(tableName, id);
+        if (!loc.has_value()) return false;  // not found
+        if (!tombstoneRecord(tableName, loc.value())) return false;
+        indexFor(tableName).erase(id);
+        return true;
+    }
+
+    // Marks one slot dead and writes back only its page, compacting the page
+    // once enough dead space has piled up in it.
+    bool StorageEngine::tombstoneRecord(const string& tableName, const RecordID& rid) {
         Page p;
-        p.pageID = 0;
-        for (const auto& rec : records) {
-            vector<uint8_t> bytes;
-            serializeRecord(rec, bytes);
-            auto optSlot = p.insertRawRecord(bytes);
-            if (!optSlot.has_value()) {
-                vector<uint8_t> buffer; p.serializeToBuffer(buffer);
-                out.write((char*)buffer.data(), buffer.size());
-                p = Page();
-                p.pageID++;
-                p.insertRawRecord(bytes);
+        readPageFromFile(tableName, rid.pageID, p);
+        optional<RecordID> home = p.movedFrom(rid.slotID);
+        if (!p.deleteSlot(rid.slotID)) return false;
+        if (p.deadBytes() >= PAGE_COMPACT_THRESHOLD) p.compact();
+        if (!writePageToFile(tableName, rid.pageID, p)) return false;
+
+        // a moved row also drops the forwarding stub left in its home slot
+        if (home.has_value()) return tombstoneRecord(tableName, home.value());
+        return true;
+    }
+
+    // Compacts every page with dead space and truncates trailing empty pages
+    optional<VacuumStats> StorageEngine::vacuum(const string& tableName) {
+        const CatalogEntry* table = findTable(tableName);
+        if (!table || getStructureType(tableName) != StructureType::HEAP) return nullopt;
+
+        VacuumStats stats;
+        uint32_t pages = pageCount(tableName);
+        uint32_t keep = 1; // page 0 always stays
+        for (uint32_t i = 0; i < pages; ++i) {
+            Page p;
+            readPageFromFile(tableName, i, p);
+            uint16_t before = p.freeSpace();
+            if (p.rowFormat != rowFormatOf(*table) && upgradePage(*table, p)) {
+                stats.pagesUpgraded++;
+                stats.bytesReclaimed += p.freeSpace() - before;
+                writePageToFile(tableName, i, p);
+            }
+            if (p.deadBytes() > 0 || (!p.slots.empty() && !p.slots.back().active)) {
+                stats.bytesReclaimed += p.compact();
+                stats.pagesCompacted++;
+                writePageToFile(tableName, i, p);
             }
+            if (p.slotCount > 0) keep = i + 1;
         }
-        vector<uint8_t> buffer; p.serializeToBuffer(buffer);
-        out.write((char*)buffer.data(), buffer.size());
-        out.close();
-        return true;
+
+        if (keep < pages) {
+            // checkpoint first so the truncation never runs ahead of the pages on disk
+            checkpoint();
+            string path = tableDataPath(tableName);
+            bufferPool.discardFrom(path, keep);
+            fs::resize_file(path, static_cast<uintmax_t>(keep) * PAGE_SIZE);
+            freeSpaceFor(tableName).truncate(keep);
+            zoneMapFor(tableName).truncate(keep);
+            stats.pagesFreed = pages - keep;
+        }
+        return stats;
     }
 
-    bool StorageEngine::deleteRecord(const string& tableName, int id) {
-        vector<Record> records = loadAllRecords(tableName);
+    // Reads the primary key of a row (first field, INT) straight from its bytes
+    static optional<int> rowKey(const Page& p, uint16_t slotID, const RowLayout* layout) {
+        const uint8_t* row = nullptr;
+        uint16_t len = 0;
+        if (!p.recordBytes(slotID, row, len)) return nullopt;
+        return RecordView(row, len, layout).getInt(0);
+    }
 
-        size_t before = records.size();
+    // Primary-key index of a table, loaded from its .idx file (or rebuilt) on first use
+    PrimaryIndex& StorageEngine::indexFor(const string& tableName) const {
+        auto it = primaryIndexes.find(tableName);
+        if (it != primaryIndexes.end()) return it->second;
 
-        records.erase(
-            remove_if(records.begin(), records.end(),
-                [&](const Record& r) { return get<int>(r.fields[0]) == id; }),
-            records.end()
-        );
+        PrimaryIndex& idx = primaryIndexes[tableName];
+        idx = PrimaryIndex(tableIndexPath(tableName));
+        if (!idx.load()) rebuildIndex(tableName);
+        return idx;
+    }
 
-        if (records.size() == before) return false;  // not found
+    // Full scan of the table pages: id -> home RID of every live row
+    void StorageEngine::rebuildIndex(const string& tableName) const {
+        if (!fs::exists(tableDataPath(tableName))) return; // not a HEAP table
 
-        ofstream out(tableDataPath(tableName), ios::binary | ios::trunc);
-        if (!out) return false;
+        unordered_map<int, RecordID> all;
+        string path = tableDataPath(tableName);
+        uint32_t pages = pageCount(tableName);
+        for (uint32_t i = 0; i < pages; ++i) {
+            const Page* p = bufferPool.pinPage(path, i);
+            if (!p) break;
+            const RowLayout* layout = layoutFor(tableName, p->rowFormat);
+            for (uint16_t s = 0; s < p->slots.size(); ++s) {
+                auto key = rowKey(*p, s, layout);
+                if (!key.has_value()) continue;
+                all[key.value()] = p->movedFrom(s).value_or(RecordID{i, s});
+            }
+            bufferPool.unpinPage(path, i, false);
+        }
+
+        // written at the next checkpoint, together with the pages it was built from
+        primaryIndexes[tableName].reset(move(all));
+    }
+
+    // Free-space map of a table, loaded from its .fsm file (or rebuilt) on first use
+    FreeSpaceMap& StorageEngine::freeSpaceFor(const string& tableName) const {
+        auto it = freeSpaceMaps.find(tableName);
+        if (it != freeSpaceMaps.end()) return it->second;
+
+        FreeSpaceMap& fsm = freeSpaceMaps[tableName];
+        fsm = FreeSpaceMap(tableFreeSpacePath(tableName));
+        if (!fsm.load(pageCount(tableName))) rebuildFreeSpaceMap(tableName);
+        return fsm;
+    }
+
+    // Reads every page once; written at the next checkpoint like a rebuilt index
+    void StorageEngine::rebuildFreeSpaceMap(const string& tableName) const {
+        string path = tableDataPath(tableName);
+        uint32_t pages = pageCount(tableName);
+        vector<uint16_t> freeBytes(pages, 0);
+        for (uint32_t i = 0; i < pages; ++i) {
+            const Page* p = bufferPool.pinPage(path, i);
+            if (!p) break;
+            freeBytes[i] = p->freeSpace() + p->deadBytes();
+            bufferPool.unpinPage(path, i, false);
+        }
+        freeSpaceMaps[tableName].reset(freeBytes);
+    }
+
+    // Zone map of a table, loaded from its .zmap file (or rebuilt) on first use
+    ZoneMap& StorageEngine::zoneMapFor(const string& tableName) const {
+        auto it = zoneMaps.find(tableName);
+        if (it != zoneMaps.end()) return it->second;
+
+        const CatalogEntry* table = findTable(tableName);
+        ZoneMap& zones = zoneMaps[tableName];
+        zones = ZoneMap(tableZoneMapPath(tableName), table ? table->types : vector<DataType>());
+        if (!zones.load(pageCount(tableName))) rebuildZoneMap(tableName);
+        return zones;
+    }
+
+    // Reads every page once; written at the next checkpoint like the free-space map
+    void StorageEngine::rebuildZoneMap(const string& tableName) const {
+        string path = tableDataPath(tableName);
+        uint32_t pages = pageCount(tableName);
+        const CatalogEntry* table = findTable(tableName);
+        if (!table || table->types.empty()) return;
+        ZoneMap& zones = zoneMaps[tableName];
+        for (uint32_t i = 0; i < pages; ++i) {
+            const Page* p = bufferPool.pinPage(path, i);
+            if (!p) break;
+            zones.update(i, *p, layoutFor(tableName, p->rowFormat));
+            bufferPool.unpinPage(path, i, false);
+        }
+    }
+
+    // Follows the index entry (and a forwarding stub) to the slot holding the row bytes
+    optional<RecordID> StorageEngine::resolveRecord(const string& tableName, const RecordID& home, int id) const {
+        if (home.pageID >= pageCount(tableName)) return nullopt;
+        Page p;
+        readPageFromFile(tableName, home.pageID, p);
+        RecordID actual = home;
+        if (auto target = p.forwardTarget(home.slotID)) {
+            actual = target.value();
+            if (actual.pageID >= pageCount(tableName)) return nullopt;
+            if (actual.pageID != home.pageID) readPageFromFile(tableName, actual.pageID, p);
+        }
+        auto key = rowKey(p, actual.slotID, layoutFor(tableName, p.rowFormat));
+        if (!key.has_value() || key.value() != id) return nullopt;
+        return actual;
+    }
+
+    // Page/slot of the live row with this id: O(1) through the primary-key index
+    optional<RecordID> StorageEngine::findRecordLocation(const string& tableName, int id) const {
+        auto home = indexFor(tableName).find(id);
+        if (!home.has_value()) return nullopt;
+
+        auto actual = resolveRecord(tableName, home.value(), id);
+        if (actual.has_value()) return actual;
+
+        // index out of sync with the pages (e.g. crash before a checkpoint): rebuild once
+        rebuildIndex(tableName);
+        home = indexFor(tableName).find(id);
+        if (!home.has_value()) return nullopt;
+        return resolveRecord(tableName, home.value(), id);
+    }
+
+    // Places a row in the first page the free-space map says has room (compacting
+    // that page if its room is dead space), or in a new page at the end of the file
+    optional<RecordID> StorageEngine::appendRecordBytes(const string& tableName, const vector<uint8_t>& bytes, uint8_t flags) {
+        const CatalogEntry* table = findTable(tableName);
+        if (!table) return nullopt;
+        FreeSpaceMap& fsm = freeSpaceFor(tableName);
+        uint16_t need = static_cast<uint16_t>(bytes.size() + sizeof(SlotEntry));
 
         Page p;
-        p.pageID = 0;
-        for (const auto& rec : records) {
-            vector<uint8_t> bytes;
-            serializeRecord(rec, bytes);
-            auto optSlot = p.insertRawRecord(bytes);
-            if (!optSlot.has_value()) {
-                vector<uint8_t> buffer; p.serializeToBuffer(buffer);
-                out.write((char*)buffer.data(), buffer.size());
-                p = Page(); p.pageID++;
-                p.insertRawRecord(bytes);
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            auto target = fsm.findPage(need);
+            if (!target.has_value() || target.value() >= pageCount(tableName)) break;
+
+            readPageFromFile(tableName, target.value(), p);
+            if (!upgradePage(*table, p)) {
+                fsm.update(target.value(), 0); // rows that cannot be converted: leave the page alone
+                continue;
+            }
+            auto slot = p.insertRawRecord(bytes, flags);
+            if (!slot.has_value() && p.deadBytes() > 0) {
+                p.compact();
+                slot = p.insertRawRecord(bytes, flags);
+            }
+            if (slot.has_value()) {
+                if (!writePageToFile(tableName, target.value(), p, slot.value())) return nullopt;
+                return RecordID{target.value(), slot.value()};
             }
+            // stale entry: correct it and look again
+            fsm.update(target.value(), p.freeSpace() + p.deadBytes());
         }
-        vector<uint8_t> buffer; p.serializeToBuffer(buffer);
-        out.write((char*)buffer.data(), buffer.size());
-        out.close();
 
-        return true;
+        uint32_t target = appendEmptyPage(tableName);
+        p = Page();
+        p.pageID = target;
+        p.rowFormat = rowFormatOf(*table);
+        auto slot = p.insertRawRecord(bytes, flags);
+        if (!slot.has_value()) return nullopt; // record larger than a page
+        if (!writePageToFile(tableName, target, p, slot.value())) return nullopt;
+        return RecordID{target, slot.value()};
     }
 
     vector<Record> StorageEngine::selectAll(const string& tableName) {
-        if (tableStructures.find(tableName) == tableStructures.end()) {
-             if (readMetaFile(tableName).has_value()) tableStructures[tableName] = StructureType::HEAP;
-             else return {};
+        vector<Record> rows;
+        auto cursor = openCursor(tableName);
+        if (!cursor) return rows;
+        Record rec;
+        while (cursor->next(rec)) rows.push_back(move(rec));
+        return rows;
+    }
+
+    // HEAP cursor: holds one page at a time. In BUFFERED mode the current page is copied
+    // out of the buffer pool; in MMAP mode the .tbl file is mapped read-only and pages are
+    // parsed in place; in ASYNC mode the pages to visit are read ahead of the scan and parsed
+    // in the reader's buffers. Falls back to BUFFERED if the file cannot be opened or the pool
+    // holds pages of the table that have not been checkpointed yet (the file would miss them).
+    // The predicate is checked on a RecordView of the slot bytes; only matches are materialized.
+    // Pages whose zone map entry rules the predicate out are not read at all.
+    class StorageEngine::HeapCursor : public Cursor {
+    public:
+        HeapCursor(const StorageEngine& engine, const string& tableName, optional<ScanPredicate> predicate)
+            : storage(engine), table(tableName), where(move(predicate)), pages(engine.pageCount(tableName)),
+              fixedLayout(engine.layoutFor(tableName, ROW_FORMAT_FIXED)),
+              zones(where ? &engine.zoneMapFor(tableName) : nullptr) {
+            string path = engine.tableDataPath(tableName);
+            if (engine.scanMode == ScanMode::MMAP) {
+                if (!engine.bufferPool.hasDirtyPages(path) && file.open(path, true))
+                    pages = static_cast<uint32_t>(file.size() / PAGE_SIZE);
+            } else if (engine.scanMode == ScanMode::ASYNC && !engine.bufferPool.hasDirtyPages(path)) {
+                // the zone map is consulted up front, so only pages that may match are read
+                vector<uint32_t> wanted;
+                for (uint32_t i = 0; i < pages; ++i)
+                    if (!zones || zones->mayMatch(i, *where)) wanted.push_back(i);
+                reader.open(path, move(wanted), engine.readAheadPages);
+            }
         }
 
-        switch (tableStructures[tableName]) {
-            case StructureType::AVL:
-                return avlTables[tableName].getAllSorted();
-            case StructureType::BST:
-                return bstTables[tableName].getAllSorted();
-            case StructureType::HASH:
-                return hashTables[tableName].getAll();
-            case StructureType::HEAP:
-            default:
-                vector<Record> outRecords;
-                uint32_t pages = pageCount(tableName);
-                for (uint32_t i = 0; i < pages; ++i) {
-                    Page p; readPageFromFile(tableName, i, p);
-                    for (uint16_t s = 0; s < p.slots.size(); ++s) {
-                        if (!p.slots[s].active) continue;
-                        vector<uint8_t> raw; p.readRawRecord(s, raw);
-                        Record rec; if (deserializeRecord(raw, rec)) outRecords.push_back(move(rec));
+        bool next(Record& out) override {
+            while (pageIndex < pages) {
+                if (!loaded) {
+                    if (reader.isOpen()) {
+                        raw = reader.next(pageIndex);
+                        if (!raw) break;
+                    } else if (zones && !zones->mayMatch(pageIndex, *where)) {
+                        pageIndex++;
+                        continue;
+                    } else if (file.isOpen()) {
+                        raw = file.data() + static_cast<size_t>(pageIndex) * PAGE_SIZE;
+                    } else {
+                        storage.readPageFromFile(table, pageIndex, page);
+                    }
+                    slot = 0;
+                    loaded = true;
+                }
+                const uint8_t* ptr = nullptr;
+                uint16_t len = 0;
+                if (raw) {
+                    PageView view(raw);
+                    layout = (view.rowFormat() == ROW_FORMAT_FIXED) ? fixedLayout : nullptr;
+                    uint16_t slots = view.slotCount();
+                    while (slot < slots) {
+                        if (view.recordBytes(slot++, ptr, len) && emit(ptr, len, out)) return true;
+                    }
+                } else {
+                    layout = (page.rowFormat == ROW_FORMAT_FIXED) ? fixedLayout : nullptr;
+                    while (slot < page.slots.size()) {
+                        // dead slots and forwarding stubs are skipped (moved rows are read at their new page)
+                        if (page.recordBytes(slot++, ptr, len) && emit(ptr, len, out)) return true;
                     }
                 }
-                return outRecords;
+                pageIndex++;
+                loaded = false;
+            }
+            close();
+            return false;
         }
-    }
 
-    // Helper method to load all records from a table (used by update/delete to avoid redundancy)
-    vector<Record> StorageEngine::loadAllRecords(const string& tableName) const {
-        vector<Record> records;
-        string path = tableDataPath(tableName);
+        void close() override {
+            pageIndex = pages;
+            raw = nullptr;
+            file.close();
+            reader.close();
+        }
 
-        ifstream in(path, ios::binary);
-        if (!in) return records;
+    private:
+        const StorageEngine& storage;
+        string table;
+        optional<ScanPredicate> where;
+        uint32_t pages;
+        uint32_t pageIndex = 0;
+        uint16_t slot = 0;
+        bool loaded = false;
+        Page page;
+        MappedFile file;
+        AsyncPageReader reader;
+        const uint8_t* raw = nullptr; // current page bytes (MMAP / ASYNC)
+        const RowLayout* fixedLayout; // table schema, for pages of fixed-layout rows
+        const RowLayout* layout = nullptr; // of the current page
+        const ZoneMap* zones;              // only with a predicate
+
+        bool emit(const uint8_t* ptr, uint16_t len, Record& out) const {
+            RecordView row(ptr, len, layout);
+            if (where && !where->matches(row)) return false;
+            return row.materialize(out);
+        }
+    };
+
+    // BTREE cursor: walks the leaf chain in id order, holding one leaf at a time. A predicate
+    // on the id (column 0) becomes a key range: the scan starts at the first id it allows and
+    // stops after the last, so rows outside the range are never read.
+    class StorageEngine::BTreeCursor : public Cursor {
+    public:
+        BTreeCursor(const BPlusTree& tree, const RowLayout* rowLayout, optional<ScanPredicate> predicate)
+            : layout(rowLayout), where(move(predicate)) {
+            int first = INT_MIN;
+            if (where) open = where->idRange(first, last);
+            if (open) it = tree.seek(first);
+        }
 
-        while (true) {
-            vector<uint8_t> buffer(PAGE_SIZE);
-            if (!in.read((char*)buffer.data(), buffer.size())) break;
+        bool next(Record& out) override {
+            int key = 0;
+            const uint8_t* row = nullptr;
+            uint16_t len = 0;
+            while (open && it.next(key, row, len)) {
+                if (key > last) break;
+                RecordView view(row, len, layout);
+                if (where && !where->matches(view)) continue;
+                if (view.materialize(out)) return true;
+            }
+            close();
+            return false;
+        }
 
-            Page p;
-            p.deserializeFromBuffer(buffer);
+        void close() override { open = false; }
 
-            if (p.slotCount == 0) break;
+    private:
+        BPlusTree::Iterator it;
+        const RowLayout* layout;
+        optional<ScanPredicate> where;
+        int last = INT_MAX;
+        bool open = true;
+    };
 
-            for (uint16_t s = 0; s < p.slots.size(); ++s) {
-                if (!p.slots[s].active) continue;
-                vector<uint8_t> raw;
-                if (p.readRawRecord(s, raw)) {
-                    Record rec;
-                    if (deserializeRecord(raw, rec)) {
-                        records.push_back(rec);
-                    }
-                }
+    unique_ptr<Cursor> StorageEngine::openCursor(const string& tableName, optional<ScanPredicate> where,
+                                                 const vector<uint16_t>& columns) {
+        if (tableStructures.find(tableName) == tableStructures.end()) {
+             if (findTable(tableName)) tableStructures[tableName] = StructureType::HEAP;
+             else return nullptr;
+        }
+
+        unique_ptr<Cursor> rows;
+        switch (tableStructures[tableName]) {
+            case StructureType::AVL: {
+                // an id predicate seeks to its first row and stops after its last: O(log N + K)
+                const AVLTree& tree = avlTables[tableName];
+                int first = INT_MIN, last = INT_MAX;
+                bool any = !where || where->idRange(first, last);
+                auto it = any ? tree.lowerBound(first).until(last) : AVLTree::InOrderIterator();
+                rows = make_unique<StructureCursor<AVLTree::InOrderIterator>>(move(it), move(where));
+                break;
             }
+            case StructureType::BST:
+                rows = make_unique<StructureCursor<BST::InOrderIterator>>(bstTables[tableName].begin(), move(where));
+                break;
+            case StructureType::HASH:
+                rows = make_unique<StructureCursor<HashTable::Iterator>>(hashTables[tableName].begin(), move(where));
+                break;
+            case StructureType::COLUMNAR:
+                // projects itself: unlisted columns are never read
+                return columnStoreFor(tableName).openCursor(move(where), columns);
+            case StructureType::BTREE:
+                rows = make_unique<BTreeCursor>(btreeFor(tableName), layoutFor(tableName, ROW_FORMAT_FIXED), move(where));
+                break;
+            case StructureType::HEAP:
+            default:
+                rows = make_unique<HeapCursor>(*this, tableName, move(where));
+                break;
         }
-        in.close();
-        return records;
+        if (columns.empty()) return rows;
+        const CatalogEntry* table = findTable(tableName);
+        for (uint16_t c : columns)
+            if (!table || c >= table->columns.size()) return nullptr;
+        return make_unique<ProjectingCursor>(move(rows), columns);
     }
 
     // --- Meta file helpers ---
     // meta format: columns=col1:TYPE,col2:TYPE,col3:TYPE
-    bool StorageEngine::writeMetaFile(const string& tableName, const vector<Column>& columns) const {
+    //             structure=HEAP|AVL|BST|HASH|COLUMNAR|BTREE (missing in older files -> HEAP)
+    //             compression=ON (COLUMNAR only; missing -> off)
+    bool StorageEngine::writeMetaFile(const string& tableName, const vector<Column>& columns, StructureType structure,
+                                      bool compressed) {
         string path = tableMetaPath(tableName);
         ofstream m(path, ios::trunc);
         if (!m) return false;
@@ -507,11 +1316,22 @@ namespace ChronoDB {
             if (i + 1 < columns.size()) m << ",";
         }
         m << "\n";
+        m << "structure=" << structureTypeName(structure) << "\n";
+        if (compressed) m << "compression=ON\n";
         m.close();
+
+        // keep the in-memory catalog in step with the file
+        CatalogEntry& entry = catalog[tableName];
+        entry.structure = structure;
+        entry.compressed = compressed;
+        entry.columns = columns;
+        entry.types.clear();
+        for (const Column& c : columns) entry.types.push_back(parseDataType(c.type));
+        entry.layout = RowLayout(entry.types);
         return true;
     }
 
-    optional<vector<Column>> StorageEngine::readMetaFile(const string& tableName) const {
+    optional<StorageEngine::CatalogEntry> StorageEngine::readMetaFile(const string& tableName) const {
         string path = tableMetaPath(tableName);
         if (!fs::exists(path)) return nullopt;
 
@@ -519,8 +1339,15 @@ namespace ChronoDB {
         if (!m) return nullopt;
 
         string line;
-        vector<Column> cols;
+        CatalogEntry table;
+        vector<Column>& cols = table.columns;
         while (getline(m, line)) {
+            if (line.rfind("structure=", 0) == 0) {
+                string type = line.substr(strlen("structure="));
+                while (!type.empty() && isspace((unsigned char)type.back())) type.pop_back();
+                table.structure = parseStructureType(type);
+            }
+            if (line.rfind("compression=ON", 0) == 0) table.compressed = true;
             // trim
             if (line.rfind("columns=", 0) == 0) {
                 string rest = line.substr(strlen("columns="));
@@ -544,11 +1371,153 @@ namespace ChronoDB {
                     cname = trim(cname);
                     ctype = trim(ctype);
                     cols.push_back({cname, ctype});
+                    table.types.push_back(parseDataType(ctype));
                 }
             }
         }
         m.close();
-        return cols;
+        table.layout = RowLayout(table.types);
+        return table;
+    }
+
+    optional<Record> StorageEngine::getRecord(const string& tableName, int id) {
+        switch (getStructureType(tableName)) {
+            case StructureType::AVL:
+                if (avlTables.find(tableName) == avlTables.end()) return nullopt;
+                return avlTables[tableName].search(id);
+            case StructureType::BST:
+                if (bstTables.find(tableName) == bstTables.end()) return nullopt;
+                return bstTables[tableName].search(id);
+            case StructureType::HASH:
+                if (hashTables.find(tableName) == hashTables.end()) return nullopt;
+                return hashTables[tableName].search(id);
+            case StructureType::COLUMNAR:
+                return columnStoreFor(tableName).findById(id);
+            case StructureType::BTREE: {
+                vector<uint8_t> row;
+                Record rec;
+                if (!btreeFor(tableName).find(id, row)) return nullopt;
+                if (!RecordView(row.data(), row.size(), layoutFor(tableName, ROW_FORMAT_FIXED)).materialize(rec)) return nullopt;
+                return rec;
+            }
+            case StructureType::HEAP:
+            default:
+                auto loc = findRecordLocation(tableName, id);
+                if (!loc.has_value()) return nullopt;
+                Page p;
+                readPageFromFile(tableName, loc->pageID, p);
+                const uint8_t* row = nullptr;
+                uint16_t len = 0;
+                Record rec;
+                if (!p.recordBytes(loc->slotID, row, len)) return nullopt;
+                if (!RecordView(row, len, layoutFor(tableName, p.rowFormat)).materialize(rec)) return nullopt;
+                return rec;
+        }
+    }
+
+    // --- Structure snapshots ---
+    // snapshot format (<table>.snap):
+    //   "CSNP" | version:u8 | structure:u8 | rowCount:u32 | lsn:u64 | rows (length:u16 + serialized record)
+    // lsn is the last log record the snapshot contains (version 1 files have none: 0)
+    // AVL rows are written in id order and HASH rows in insertion order; BST rows in pre-order
+    // so the restored tree has the same shape. Written to a temp file and renamed into place.
+    // COLUMNAR tables go through the same calls to their own manifest (see column_store.h).
+    bool StorageEngine::writeSnapshot(const string& tableName, uint64_t lsn) {
+        StructureType type = getStructureType(tableName);
+        if (type == StructureType::COLUMNAR) return columnStoreFor(tableName).checkpoint(lsn);
+        vector<Record> rows;
+        if (type == StructureType::AVL) rows = avlTables[tableName].getAllSorted();
+        else if (type == StructureType::BST) rows = bstTables[tableName].getPreOrder();
+        else if (type == StructureType::HASH) rows = hashTables[tableName].getAll();
+        else return false;
+
+        vector<uint8_t> out = {'C', 'S', 'N', 'P', 2, static_cast<uint8_t>(type)};
+        uint32_t count = static_cast<uint32_t>(rows.size());
+        out.resize(SNAPSHOT_HEADER_BYTES);
+        memcpy(out.data() + 6, &count, 4);
+        memcpy(out.data() + 10, &lsn, 8);
+
+        vector<uint8_t> bytes;
+        for (const Record& r : rows) {
+            serializeRecord(r, bytes);
+            uint16_t len = static_cast<uint16_t>(bytes.size());
+            size_t pos = out.size();
+            out.resize(pos + 2 + len);
+            memcpy(out.data() + pos, &len, 2);
+            memcpy(out.data() + pos + 2, bytes.data(), len);
+        }
+
+        string path = tableSnapshotPath(tableName);
+        string tmp = path + ".tmp";
+        {
+            ofstream f(tmp, ios::binary | ios::trunc);
+            if (!f) return false;
+            f.write(reinterpret_cast<const char*>(out.data()), out.size());
+            if (!f) return false;
+        }
+        // must be durable before the checkpoint truncates the log
+        if (!syncFile(tmp)) return false;
+        error_code ec;
+        fs::rename(tmp, path, ec);
+        return !ec;
+    }
+
+    // Reads the whole snapshot in one go and bulk-loads it (O(N) for every structure)
+    bool StorageEngine::loadSnapshot(const string& tableName, uint64_t& lsn) {
+        lsn = 0;
+        if (getStructureType(tableName) == StructureType::COLUMNAR) return columnStoreFor(tableName).load(lsn);
+        ifstream f(tableSnapshotPath(tableName), ios::binary | ios::ate);
+        if (!f) return false;
+        vector<uint8_t> in(static_cast<size_t>(f.tellg()));
+        f.seekg(0);
+        f.read(reinterpret_cast<char*>(in.data()), in.size());
+        if (in.size() < 10 || memcmp(in.data(), "CSNP", 4) != 0 || in[4] < 1 || in[4] > 2) return false;
+        size_t pos = (in[4] == 1) ? 10 : SNAPSHOT_HEADER_BYTES;
+        if (in.size() < pos) return false;
+
+        StructureType type = static_cast<StructureType>(in[5]);
+        if (type != getStructureType(tableName)) return false;
+        uint32_t count = 0;
+        memcpy(&count, in.data() + 6, 4);
+        if (in[4] == 2) memcpy(&lsn, in.data() + 10, 8);
+
+        vector<Record> rows;
+        rows.reserve(count);
+        for (uint32_t i = 0; i < count && pos + 2 <= in.size(); ++i) {
+            uint16_t len = 0;
+            memcpy(&len, in.data() + pos, 2);
+            pos += 2;
+            if (pos + len > in.size()) break;
+            Record rec;
+            if (deserializeRecord(in.data() + pos, len, rec)) rows.push_back(move(rec));
+            pos += len;
+        }
+
+        if (type == StructureType::AVL) avlTables[tableName].buildFromSorted(rows);
+        else if (type == StructureType::BST) bstTables[tableName].buildFromPreOrder(rows);
+        else {
+            HashTable& h = hashTables[tableName];
+            h.reserve(rows.size());
+            for (const Record& r : rows) h.insert(r);
+        }
+        return true;
+    }
+
+    // --- Catalog ---
+    // One directory scan at startup; afterwards schema lookups never touch the .meta files
+    void StorageEngine::loadCatalog() {
+        catalog.clear();
+        for (const auto& entry : fs::directory_iterator(storageDirectory)) {
+            if (entry.path().extension() != ".meta") continue;
+            string tableName = entry.path().stem().string();
+            auto table = readMetaFile(tableName);
+            if (table.has_value()) catalog[tableName] = move(table.value());
+        }
+    }
+
+    const StorageEngine::CatalogEntry* StorageEngine::findTable(const string& tableName) const {
+        auto it = catalog.find(tableName);
+        return it == catalog.end() ? nullptr : &it->second;
     }
 
     // --------------------------------------------------------------------------------------
@@ -557,7 +1526,7 @@ namespace ChronoDB {
     bool StorageEngine::search(const std::string& tableName, int id) {
         if (tableStructures.find(tableName) == tableStructures.end()) {
             // Attempt to load metadata to determine structure type if not already known
-            if (readMetaFile(tableName).has_value()) {
+            if (findTable(tableName)) {
                 // Default to HEAP if no specific structure type is stored in metadata
                 // For benchmarking, we assume structure type is set during table creation
                 // or inferred from existing data. If not found, treat as HEAP.
@@ -587,24 +1556,42 @@ namespace ChronoDB {
                 return res.has_value();
             }
         }
+        else if (type == StructureType::COLUMNAR) {
+            return columnStoreFor(tableName).findById(id).has_value();
+        }
+        else if (type == StructureType::BTREE) {
+            vector<uint8_t> row;
+            return btreeFor(tableName).find(id, row);
+        }
         else { // StructureType::HEAP or default
-            // HEAP: Linear Scan
-            // Read all blocks
-            // Reuse selectAll logic implicitly or just scan using selectAll for now
-            // because strict file parsing duplication is bad.
-            auto rows = selectAll(tableName);
-            for(auto& rec : rows) {
-                // Assuming ID is always the first field and an integer
-                if (get<int>(rec.fields[0]) == id) return true;
-            }
+            // HEAP: primary-key index lookup (id -> page/slot), one page read
+            return findRecordLocation(tableName, id).has_value();
         }
         return false;
     }
 
+    ColumnStore& StorageEngine::columnStoreFor(const string& tableName) {
+        auto it = columnStores.find(tableName);
+        if (it == columnStores.end()) {
+            const CatalogEntry* table = findTable(tableName);
+            it = columnStores.emplace(tableName, ColumnStore(storageDirectory + "/" + tableName,
+                                                             table ? table->types : vector<DataType>(),
+                                                             table && table->compressed)).first;
+        }
+        return it->second;
+    }
+
+    BPlusTree& StorageEngine::btreeFor(const string& tableName) {
+        auto it = btreeTables.find(tableName);
+        if (it == btreeTables.end())
+            it = btreeTables.emplace(tableName, BPlusTree(bufferPool, tableBTreePath(tableName))).first;
+        return it->second;
+    }
+
     vector<Column> StorageEngine::getTableColumns(const string& tableName) const {
-        auto opt = readMetaFile(tableName);
-        if (!opt.has_value()) return {};
-        return opt.value();
+        const CatalogEntry* table = findTable(tableName);
+        if (!table) return {};
+        return table->columns;
     }
 
     StorageEngine::StructureType StorageEngine::getStructureType(const string& tableName) const {
@@ -614,22 +1601,17 @@ namespace ChronoDB {
         return StructureType::HEAP;
     }
 
-    // GUI Helper: Scan directory for tables
+    // GUI Helper: list tables from the catalog
     vector<string> StorageEngine::getTableNames() const {
         vector<string> tables;
-        if (!fs::exists(storageDirectory)) return tables;
-
-        for (const auto& entry : fs::directory_iterator(storageDirectory)) {
-            if (entry.path().extension() == ".meta") {
-                // filename without extension is table name
-                tables.push_back(entry.path().stem().string());
-            }
-        }
+        tables.reserve(catalog.size());
+        for (const auto& [name, entry] : catalog) tables.push_back(name);
+        sort(tables.begin(), tables.end());
         return tables;
     }
 
     bool StorageEngine::tableExists(const string& tableName) const {
-         return fs::exists(tableMetaPath(tableName));
+         return findTable(tableName) != nullptr;
     }
 
 } // namespace ChronoDB
\ No newline at end of file
@@ -7,8 +7,21 @@
 #include <fstream>
 #include <optional>
 #include "../utils/types.h"
-#include "../utils/types.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "primary_index.h"
+#include "free_space_map.h"
+#include "zone_map.h"
+#include "mapped_file.h"
+#include "async_io.h"
+#include "cursor.h"
+#include "column_store.h"
+#include "btree.h"
+#include "wal.h"
+#include "file_io.h"
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include "../src/structures/avl_tree.h"
 #include "../src/structures/bst.h"
 #include "../src/structures/hash_table.h"
@@ -28,38 +41,33 @@ namespace ChronoDB {
         string primaryKey;
     }; 
 
-    // -------- Page Constants --------
-    static constexpr uint32_t PAGE_SIZE = 8192; // 8 KB
-    static constexpr uint16_t PAGE_HEADER_RESERVED = 64;
-
-    struct SlotEntry {
-        uint16_t offset;
-        uint16_t length;
-        bool active;
-        SlotEntry(uint16_t o = 0, uint16_t l = 0, bool a = true)
-            : offset(o), length(l), active(a) {}
+    // Result of VACUUM <table>
+    struct VacuumStats {
+        uint32_t pagesCompacted = 0;
+        uint32_t pagesFreed = 0;     // trailing empty pages truncated from the file
+        uint32_t pagesUpgraded = 0;  // pages converted from tagged to fixed-layout rows
+        size_t bytesReclaimed = 0;
     };
 
-    struct Page {
-        uint32_t pageID = 0;
-        uint16_t slotCount = 0;
-        uint16_t freeSpaceOffset = PAGE_HEADER_RESERVED;
-
-        vector<SlotEntry> slots;
-        vector<uint8_t> data;
-
-        Page() {
-            data.resize(PAGE_SIZE, 0);
-        }
-
-        uint16_t usedDataBytes() const { return freeSpaceOffset; }
-        uint16_t freeSpace() const;
-        optional<uint16_t> insertRawRecord(const vector<uint8_t>& rec);
-        bool deleteSlot(uint16_t slotID);
-        bool readRawRecord(uint16_t slotID, vector<uint8_t>& out) const;
+    // Options for COPY <table> FROM '<file>'
+    struct BulkLoadOptions {
+        char delimiter = 0;   // 0: by file extension (.tsv -> tab, otherwise ',')
+        bool header = false;  // first line holds column names
+        unsigned threads = 1; // parser threads; 0: one per core. Rows are still written by one thread
+    };
 
-        void serializeToBuffer(vector<uint8_t>& buffer) const;
-        void deserializeFromBuffer(const vector<uint8_t>& buffer);
+    // Result of a bulk load
+    struct BulkLoadStats {
+        size_t rowsLoaded = 0;
+        size_t rowsRejected = 0;   // wrong field count, type mismatch or larger than a page
+        uint64_t bytesRead = 0;
+        uint32_t pagesWritten = 0; // HEAP tables
+        unsigned threads = 1;      // parser threads used
+        double seconds = 0;
+        string firstError;         // "line N: ..." of the first rejected row
+
+        double rowsPerSecond() const { return seconds > 0 ? rowsLoaded / seconds : 0; }
+        double megabytesPerSecond() const { return seconds > 0 ? bytesRead / (1024.0 * 1024.0) / seconds : 0; }
     };
 
     struct TableMeta {
@@ -69,7 +77,7 @@ namespace ChronoDB {
 
     class StorageEngine {
     public:
-        StorageEngine(const string& storageDir = "./data");
+        StorageEngine(const string& storageDir = "./data", size_t bufferPoolBytes = DEFAULT_BUFFER_POOL_BYTES);
         ~StorageEngine();
 
         // Create table WITH schema
@@ -78,17 +86,68 @@ namespace ChronoDB {
         // Old version (no schema)
         bool createTable(const string& tableName);
 
+        // insert/update/deleteRecord: false if the write was refused, or applied but its log
+        // record could not be made durable
         bool insertRecord(const string& tableName, const Record& rec);
         vector<Record> selectAll(const string& tableName);
 
+        // Streaming scan: HEAP in page/slot order, AVL/BST/BTREE in id order, HASH and
+        // COLUMNAR in insertion order. Only rows matching the optional predicate are returned,
+        // holding only the listed columns (all if empty); COLUMNAR tables read nothing else
+        // and BTREE tables only the id range a predicate on the id allows.
+        // Returns nullptr if the table or a column does not exist.
+        unique_ptr<Cursor> openCursor(const string& tableName, optional<ScanPredicate> where = nullopt,
+                                      const vector<uint16_t>& columns = {});
+
         bool updateRecord(const string& tableName, int id, const Record& newRecord);
         bool deleteRecord(const string& tableName, int id);
 
+        // Bulk load a CSV/TSV file (see bulk_load.cpp). With options.threads > 1 the file is
+        // parsed in chunks on a worker pool. HEAP rows are packed into full pages
+        // written straight to the table file; AVL/BST are rebuilt from the sorted rows.
+        // The load is not logged: it ends with a checkpoint. Returns nullopt if the table
+        // does not exist, has no INT key column or the file cannot be read.
+        optional<BulkLoadStats> bulkLoad(const string& tableName, const string& filePath, const BulkLoadOptions& options = {});
+
+        // Reclaim dead space left by deletes and convert pages still holding tagged rows
+        // to the fixed row format (HEAP tables)
+        optional<VacuumStats> vacuum(const string& tableName);
+
+        // Point lookup by primary key (HEAP: page/slot lookup instead of a full selectAll)
+        optional<Record> getRecord(const string& tableName, int id);
+
         // BENCHMARKING AID
         bool search(const std::string& tableName, int id); // Returns true if found
 
-        bool writePageToFile(const string& tableName, uint32_t pageIndex, const Page& page);
-        bool readPageFromFile(const string& tableName, uint32_t pageIndex, Page& outPage);
+        // appendedSlot: the write only added the row in this slot (zone map widened, not rebuilt)
+        bool writePageToFile(const string& tableName, uint32_t pageIndex, const Page& page, int appendedSlot = -1);
+        bool readPageFromFile(const string& tableName, uint32_t pageIndex, Page& outPage) const;
+
+        // Checkpoint: write back dirty pages, index files and AVL/BST/HASH snapshots,
+        // then truncate the write-ahead log
+        void checkpoint();
+
+        // Group commit: writes between beginBatch() and commitBatch() share one log fsync
+        // (batches nest; a crash loses at most the uncommitted tail of the batch)
+        void beginBatch();
+        bool commitBatch();
+        const WriteAheadLog& getWal() const { return wal; }
+
+        // Buffer pool (page cache shared by all HEAP tables)
+        void setBufferPoolSize(size_t bytes) { bufferPool.setBudget(bytes); }
+        const BufferPool& getBufferPool() const { return bufferPool; }
+        void resetBufferPoolStats() { bufferPool.resetStats(); }
+
+        // HEAP full-scan path: BUFFERED reads pages through the buffer pool,
+        // MMAP parses them straight out of a read-only mapping of the .tbl file
+        // (faster for large, read-mostly tables; does not populate the pool),
+        // ASYNC keeps readAhead page reads in flight (io_uring or a thread pool, see async_io.h)
+        // while the scan decodes earlier pages; like MMAP it bypasses the pool
+        enum class ScanMode { BUFFERED, MMAP, ASYNC };
+        void setScanMode(ScanMode mode) { scanMode = mode; }
+        ScanMode getScanMode() const { return scanMode; }
+        void setReadAhead(uint32_t pages) { readAheadPages = pages; }
+        uint32_t getReadAhead() const { return readAheadPages; }
 
         // Schema access
         vector<Column> getTableColumns(const string& tableName) const;
@@ -99,37 +158,131 @@ namespace ChronoDB {
 
     private:
         string storageDirectory;
+        mutable BufferPool bufferPool;
+        ScanMode scanMode = ScanMode::BUFFERED;
+        uint32_t readAheadPages = 32;
+
+        // Write-ahead log (see wal.h): every INSERT/UPDATE/DELETE is logged after it is
+        // applied; dirty pages stay in the (no-steal) pool until the next checkpoint
+        static constexpr uint64_t WAL_CHECKPOINT_BYTES = 16 * 1024 * 1024;
+        WriteAheadLog wal;
+        int batchDepth = 0;
+        bool replaying = false;
+        bool logWrite(WalOp op, const string& tableName, int id, const vector<uint8_t>& row);
+        static bool serializeForLog(const string& tableName, const Record& rec, vector<uint8_t>& row);
+        string doubleWritePath() const;
+
+        bool applyInsert(const string& tableName, const Record& rec);
+        bool applyUpdate(const string& tableName, int id, const Record& newRecord);
+        bool applyDelete(const string& tableName, int id);
 
         string tableDataPath(const string& tableName) const;
         string tableMetaPath(const string& tableName) const;
-
+        string tableIndexPath(const string& tableName) const;
+
+        // Primary-key index per HEAP table (id -> home RID), see primary_index.h
+        mutable unordered_map<string, PrimaryIndex> primaryIndexes;
+        PrimaryIndex& indexFor(const string& tableName) const;
+        void rebuildIndex(const string& tableName) const;
+        optional<RecordID> resolveRecord(const string& tableName, const RecordID& home, int id) const;
+
+        // Free-space map per HEAP table (reusable bytes per page), see free_space_map.h
+        mutable unordered_map<string, FreeSpaceMap> freeSpaceMaps;
+        FreeSpaceMap& freeSpaceFor(const string& tableName) const;
+        void rebuildFreeSpaceMap(const string& tableName) const;
+        string tableFreeSpacePath(const string& tableName) const;
+
+        // Zone map per HEAP table (min/max of each column per page), see zone_map.h
+        mutable unordered_map<string, ZoneMap> zoneMaps;
+        ZoneMap& zoneMapFor(const string& tableName) const;
+        void rebuildZoneMap(const string& tableName) const;
+        string tableZoneMapPath(const string& tableName) const;
+
+        // Tagged rows (log, snapshots, pages of tables without columns)
         static void serializeRecord(const Record& r, vector<uint8_t>& out);
         static bool deserializeRecord(const vector<uint8_t>& in, Record& out);
-        vector<Record> loadAllRecords(const string& tableName) const;
+        static bool deserializeRecord(const uint8_t* in, size_t size, Record& out);
+        class HeapCursor;
+        optional<RecordID> findRecordLocation(const string& tableName, int id) const;
+        optional<RecordID> appendRecordBytes(const string& tableName, const vector<uint8_t>& bytes, uint8_t flags = 0);
+        bool rewriteRecord(const string& tableName, const RecordID& rid, const vector<uint8_t>& bytes);
+        bool tombstoneRecord(const string& tableName, const RecordID& rid);
 
         uint32_t pageCount(const string& tableName) const;
         uint32_t appendEmptyPage(const string& tableName);
 
+    public:
+        enum class StructureType { HEAP, AVL, BST, HASH, COLUMNAR, BTREE };
+
+    private:
+        // --- Catalog (schemas cached in memory, loaded once at startup) ---
+        struct CatalogEntry {
+            vector<Column> columns;
+            vector<DataType> types;   // pre-resolved column types
+            RowLayout layout;         // fixed row layout (empty for tables without columns)
+            StructureType structure = StructureType::HEAP;
+            bool compressed = false;  // COLUMNAR: dictionary / run-length / delta encoded segments
+        };
+        unordered_map<string, CatalogEntry> catalog;
+
+        void loadCatalog();
+        const CatalogEntry* findTable(const string& tableName) const;
+
         // helpers
-        bool writeMetaFile(const string& tableName, const vector<Column>& columns) const;
-        optional<vector<Column>> readMetaFile(const string& tableName) const;
-        static bool typeStringMatchesValue(const string& typeStr, const RecordValue& v);
+        bool writeMetaFile(const string& tableName, const vector<Column>& columns, StructureType structure, bool compressed = false);
+        optional<CatalogEntry> readMetaFile(const string& tableName) const;
+        static DataType parseDataType(const string& typeStr);
+        static StructureType parseStructureType(const string& typeStr);
+        static string structureTypeName(StructureType type);
+        static bool valueMatchesType(DataType type, const RecordValue& v);
+        static bool recordMatchesSchema(const CatalogEntry& table, const Record& rec);
+
+        // --- HEAP row format (see ROW_FORMAT_* in page.h) ---
+        static uint8_t rowFormatOf(const CatalogEntry& table);
+        static bool encodeRow(const CatalogEntry& table, const Record& rec, vector<uint8_t>& out);
+        static bool upgradePage(const CatalogEntry& table, Page& p);
+        const RowLayout* layoutFor(const string& tableName, uint8_t rowFormat) const;
+
+        // --- Bulk load (bulk_load.cpp) ---
+        class RowSource;
+        class CsvReader;
+        class ParallelCsvReader;
+        void bulkLoadHeap(const string& tableName, RowSource& reader, BulkLoadStats& stats);
+        void bulkLoadStructure(const string& tableName, RowSource& reader, BulkLoadStats& stats);
 
         // --- Multi-Structure Management ---
-        enum class StructureType { HEAP, AVL, BST, HASH };
-        
         // Registry: TableName -> StructureType
         unordered_map<string, StructureType> tableStructures;
 
-        // In-Memory Structures (since we aren't persisting them to disk for this project demo)
+        // In-Memory Structures, persisted as binary snapshots (<table>.snap) at checkpoint
         // TableName -> Instance
         unordered_map<string, AVLTree> avlTables;
         unordered_map<string, BST> bstTables;
         unordered_map<string, HashTable> hashTables;
+        unordered_set<string> dirtySnapshots; // structures changed since the last checkpoint
+
+        // COLUMNAR tables: per-column segment files (<table>.<n>.seg) + manifest (<table>.colm),
+        // checkpointed alongside the snapshots
+        unordered_map<string, ColumnStore> columnStores;
+        ColumnStore& columnStoreFor(const string& tableName);
+
+        // BTREE tables: rows in the leaves of a disk B+Tree (<table>.btree, see btree.h) whose
+        // nodes go through the buffer pool and the log like HEAP pages (no snapshot)
+        unordered_map<string, BPlusTree> btreeTables;
+        BPlusTree& btreeFor(const string& tableName);
+        string tableBTreePath(const string& tableName) const;
+        class BTreeCursor;
+
+        static constexpr size_t SNAPSHOT_HEADER_BYTES = 18;
+        string tableSnapshotPath(const string& tableName) const;
+        bool writeSnapshot(const string& tableName, uint64_t lsn);
+        bool loadSnapshot(const string& tableName, uint64_t& lsn);
 
     public:
-        // Expose method to create with specific structure
-        bool createTable(const string& tableName, const vector<Column>& columns, const string& structureType);
+        // Expose method to create with specific structure. compressed (COLUMNAR only) stores
+        // segments dictionary / run-length / delta encoded where that is smaller.
+        bool createTable(const string& tableName, const vector<Column>& columns, const string& structureType,
+                         bool compressed = false);
         
         // Expose method to get structure type
         StructureType getStructureType(const string& tableName) const;
@@ -139,6 +292,10 @@ namespace ChronoDB {
              if (bstTables.find(tableName) != bstTables.end()) return &bstTables[tableName];
              return nullptr;
         }
+        const AVLTree* getAVL(const string& tableName) const {
+             auto it = avlTables.find(tableName);
+             return it == avlTables.end() ? nullptr : &it->second;
+        }
 
         // GUI HELPERS
         // Returns list of all table names found in data directory
@@ -0,0 +1,107 @@
+// wal.cpp
+#include "wal.h"
+#include <fstream>
+#include <cstring>
+using namespace std;
+
+namespace ChronoDB {
+
+    bool WriteAheadLog::writeHeader(uint64_t baseLSN) {
+        uint8_t header[HEADER_BYTES] = {'C', 'W', 'A', 'L', VERSION, 0, 0, 0};
+        memcpy(header + 8, &baseLSN, 8);
+        if (!file.open(path, true) || !file.append(header, HEADER_BYTES) || !file.sync()) return false;
+        base = next = baseLSN;
+        logBytes = HEADER_BYTES;
+        return true;
+    }
+
+    bool WriteAheadLog::open(vector<WalRecord>& records) {
+        records.clear();
+        pending.clear();
+
+        vector<uint8_t> in;
+        {
+            ifstream f(path, ios::binary | ios::ate);
+            if (f) {
+                in.resize(static_cast<size_t>(f.tellg()));
+                f.seekg(0);
+                f.read(reinterpret_cast<char*>(in.data()), in.size());
+            }
+        }
+        if (in.size() < HEADER_BYTES || memcmp(in.data(), "CWAL", 4) != 0 || in[4] != VERSION)
+            return writeHeader(1);
+
+        memcpy(&base, in.data() + 8, 8);
+        next = base;
+
+        size_t pos = HEADER_BYTES;
+        while (pos + 8 <= in.size()) {
+            uint32_t length = 0, crc = 0;
+            memcpy(&length, in.data() + pos, 4);
+            memcpy(&crc, in.data() + pos + 4, 4);
+            const uint8_t* body = in.data() + pos + 8;
+            if (length < 16 || pos + 8 + length > in.size() || crc32(body, length) != crc) break;
+
+            WalRecord r;
+            memcpy(&r.lsn, body, 8);
+            r.op = static_cast<WalOp>(body[8]);
+            memcpy(&r.id, body + 9, 4);
+            uint8_t nameLength = body[13];
+            if (14u + nameLength + 2u > length) break;
+            r.table.assign(reinterpret_cast<const char*>(body + 14), nameLength);
+            uint16_t rowLength = 0;
+            memcpy(&rowLength, body + 14 + nameLength, 2);
+            if (16u + nameLength + rowLength != length) break;
+            r.row.assign(body + 16 + nameLength, body + 16 + nameLength + rowLength);
+
+            next = r.lsn + 1;
+            records.push_back(move(r));
+            pos += 8 + length;
+        }
+
+        // drop a torn tail so new records follow the last good one
+        if (!file.open(path) || !file.truncate(pos)) return false;
+        logBytes = pos;
+        return true;
+    }
+
+    uint64_t WriteAheadLog::append(WalOp op, const string& table, int32_t id, const vector<uint8_t>& row) {
+        if (!fits(table, row)) return 0;
+        uint64_t lsn = next++;
+        uint8_t nameLength = static_cast<uint8_t>(table.size());
+        uint16_t rowLength = static_cast<uint16_t>(row.size());
+        uint32_t length = 16 + nameLength + rowLength;
+
+        size_t start = pending.size();
+        pending.resize(start + 8 + length);
+        uint8_t* body = pending.data() + start + 8;
+        memcpy(body, &lsn, 8);
+        body[8] = static_cast<uint8_t>(op);
+        memcpy(body + 9, &id, 4);
+        body[13] = nameLength;
+        memcpy(body + 14, table.data(), nameLength);
+        memcpy(body + 14 + nameLength, &rowLength, 2);
+        if (rowLength) memcpy(body + 16 + nameLength, row.data(), rowLength);
+
+        uint32_t crc = crc32(body, length);
+        memcpy(pending.data() + start, &length, 4);
+        memcpy(pending.data() + start + 4, &crc, 4);
+        return lsn;
+    }
+
+    bool WriteAheadLog::commit() {
+        if (pending.empty()) return true;
+        if (!file.isOpen() && !file.open(path)) return false;
+        if (!file.append(pending.data(), pending.size()) || !file.sync()) return false;
+        logBytes += pending.size();
+        pending.clear();
+        syncs++;
+        return true;
+    }
+
+    bool WriteAheadLog::reset(uint64_t nextLSN) {
+        pending.clear();
+        return writeHeader(nextLSN);
+    }
+
+} // namespace ChronoDB
@@ -0,0 +1,75 @@
+#ifndef CHRONODB_WAL_H
+#define CHRONODB_WAL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "file_io.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    enum class WalOp : uint8_t { INSERT = 1, UPDATE = 2, DELETE = 3 };
+
+    // One logged statement (logical redo: replayed through the normal write path)
+    struct WalRecord {
+        uint64_t lsn = 0;
+        WalOp op = WalOp::INSERT;
+        string table;
+        int32_t id = 0;            // UPDATE/DELETE: key of the target row
+        vector<uint8_t> row;       // INSERT/UPDATE: serialized after-image
+    };
+
+    // Write-ahead log (<storageDir>/chronodb.wal).
+    //
+    // File layout:
+    //   header  : "CWAL" | version:u8 | pad:3 | baseLSN:u64
+    //   records : bodyLength:u32 | crc32:u32 | body
+    //   body    : lsn:u64 | op:u8 | id:i32 | nameLength:u8 | name | rowLength:u16 | row
+    //
+    // append() only buffers a record (nothing, returning 0, for a name or row too long for
+    // its length field: see fits()); commit() writes every pending record with a single
+    // write + fsync (group commit). A record with a bad checksum ends the log (torn tail).
+    // reset() truncates the log after a checkpoint has made its records redundant.
+    class WriteAheadLog {
+    public:
+        explicit WriteAheadLog(const string& filePath = "") : path(filePath) {}
+
+        // Opens (or creates) the log and returns the committed records in LSN order
+        bool open(vector<WalRecord>& records);
+
+        // Largest table name and row a record can carry (nameLength:u8, rowLength:u16)
+        static constexpr size_t MAX_NAME_BYTES = UINT8_MAX;
+        static constexpr size_t MAX_ROW_BYTES = UINT16_MAX;
+        static bool fits(const string& table, const vector<uint8_t>& row) {
+            return table.size() <= MAX_NAME_BYTES && row.size() <= MAX_ROW_BYTES;
+        }
+
+        uint64_t append(WalOp op, const string& table, int32_t id, const vector<uint8_t>& row);
+        bool commit();
+        bool reset(uint64_t nextLSN);
+
+        bool hasPending() const { return !pending.empty(); }
+        uint64_t baseLSN() const { return base; }
+        uint64_t lastLSN() const { return next - 1; }
+        uint64_t sizeBytes() const { return logBytes; }
+        uint64_t syncCount() const { return syncs; }
+
+    private:
+        static constexpr uint8_t VERSION = 1;
+        static constexpr size_t HEADER_BYTES = 16;
+
+        string path;
+        DurableFile file;
+        vector<uint8_t> pending;
+        uint64_t base = 1;
+        uint64_t next = 1;
+        uint64_t logBytes = 0;
+        uint64_t syncs = 0;
+
+        bool writeHeader(uint64_t baseLSN);
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_WAL_H
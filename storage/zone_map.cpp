@@ -0,0 +1,281 @@
+// zone_map.cpp
+#include "zone_map.h"
+#include "file_io.h"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+namespace ChronoDB {
+
+    ZoneMap::ZoneMap(const string& filePath, const vector<DataType>& columnTypes)
+        : path(filePath), types(columnTypes) {
+        for (DataType t : types) {
+            offset.push_back(stride);
+            stride += rangeBytes(t) + bloomBytes(t);
+        }
+    }
+
+    bool ZoneMap::load(uint32_t expectedPages) {
+        entries.clear();
+        dirty = false;
+
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in) return false;
+        vector<uint8_t> bytes(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+
+        if (bytes.size() < HEADER_BYTES + 4 || memcmp(bytes.data(), "CZMP", 4) != 0 || bytes[4] != VERSION) return false;
+        if (bytes[5] != 1 || bytes[6] != types.size()) return false; // not closed cleanly / other schema
+        uint32_t pages = 0, crc = 0;
+        memcpy(&pages, bytes.data() + 8, 4);
+        if (pages != expectedPages || bytes.size() != HEADER_BYTES + static_cast<size_t>(pages) * stride + 4) return false;
+        memcpy(&crc, bytes.data() + bytes.size() - 4, 4);
+        if (crc32(bytes.data(), bytes.size() - 4) != crc) return false;
+
+        entries.assign(bytes.begin() + HEADER_BYTES, bytes.end() - 4);
+        return true;
+    }
+
+    bool ZoneMap::checkpoint() {
+        vector<uint8_t> out = {'C', 'Z', 'M', 'P', VERSION, 1, static_cast<uint8_t>(types.size()), 0, 0, 0, 0, 0};
+        uint32_t pages = pageCount();
+        memcpy(out.data() + 8, &pages, 4);
+        out.insert(out.end(), entries.begin(), entries.end());
+        uint32_t crc = crc32(out.data(), out.size());
+        out.resize(out.size() + 4);
+        memcpy(out.data() + out.size() - 4, &crc, 4);
+
+        ofstream f(path, ios::binary | ios::trunc);
+        if (!f) return false;
+        f.write(reinterpret_cast<const char*>(out.data()), out.size());
+        if (!f) return false;
+        dirty = false;
+        return true;
+    }
+
+    void ZoneMap::markDirty() {
+        if (dirty) return;
+        dirty = true;
+        // first change since the last checkpoint: flag the file as not clean
+        fstream header(path, ios::binary | ios::in | ios::out);
+        if (!header) return;
+        header.seekp(5);
+        char flag = 0;
+        header.write(&flag, 1);
+    }
+
+    // Smallest string above every string that starts with the first STRING_BOUND_BYTES
+    // bytes of max; empty if there is none (all 0xFF)
+    string ZoneMap::upperBound(string_view max) {
+        if (max.size() <= STRING_BOUND_BYTES) return string(max);
+        string bound(max.substr(0, STRING_BOUND_BYTES));
+        while (!bound.empty() && static_cast<uint8_t>(bound.back()) == 0xFF) bound.pop_back();
+        if (!bound.empty()) bound.back() = static_cast<char>(static_cast<uint8_t>(bound.back()) + 1);
+        return bound;
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    static uint64_t hashInt(int32_t v) { return mix(static_cast<uint32_t>(v)); }
+
+    static uint64_t hashString(string_view v) {
+        uint64_t h = 0xCBF29CE484222325ULL; // FNV-1a
+        for (char c : v) h = (h ^ static_cast<uint8_t>(c)) * 0x100000001B3ULL;
+        return mix(h);
+    }
+
+    // Double hashing: bit i = h1 + i * h2
+    void ZoneMap::bloomAdd(uint8_t* bloom, uint64_t hash) {
+        uint32_t h1 = static_cast<uint32_t>(hash), h2 = static_cast<uint32_t>(hash >> 32) | 1;
+        for (uint32_t i = 0; i < BLOOM_HASHES; ++i) {
+            uint32_t bit = (h1 + i * h2) % (BLOOM_BYTES * 8);
+            bloom[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+        }
+    }
+
+    bool ZoneMap::bloomMayContain(const uint8_t* bloom, uint64_t hash) {
+        uint32_t h1 = static_cast<uint32_t>(hash), h2 = static_cast<uint32_t>(hash >> 32) | 1;
+        for (uint32_t i = 0; i < BLOOM_HASHES; ++i) {
+            uint32_t bit = (h1 + i * h2) % (BLOOM_BYTES * 8);
+            if (!(bloom[bit >> 3] & (1u << (bit & 7)))) return false;
+        }
+        return true;
+    }
+
+    // Merges the column value of one row into an entry (EMPTY -> RANGE, or widens it)
+    void ZoneMap::include(uint8_t* e, DataType type, const RecordView& row, uint16_t column) {
+        if (e[0] == ZONE_UNKNOWN) return;
+        bool first = e[0] == ZONE_EMPTY;
+        if (type == DataType::INT) {
+            auto v = row.getInt(column);
+            if (!v.has_value()) return;
+            int32_t lo = v.value(), hi = v.value();
+            if (!first) {
+                int32_t oldLo = 0, oldHi = 0;
+                memcpy(&oldLo, e + 1, 4);
+                memcpy(&oldHi, e + 5, 4);
+                lo = min(lo, oldLo);
+                hi = max(hi, oldHi);
+            }
+            memcpy(e + 1, &lo, 4);
+            memcpy(e + 5, &hi, 4);
+            bloomAdd(e + rangeBytes(type), hashInt(v.value()));
+        } else if (type == DataType::FLOAT) {
+            auto v = row.getFloat(column);
+            if (!v.has_value() || std::isnan(v.value())) return;
+            float lo = v.value(), hi = v.value();
+            if (!first) {
+                float oldLo = 0, oldHi = 0;
+                memcpy(&oldLo, e + 1, 4);
+                memcpy(&oldHi, e + 5, 4);
+                lo = min(lo, oldLo);
+                hi = max(hi, oldHi);
+            }
+            memcpy(e + 1, &lo, 4);
+            memcpy(e + 5, &hi, 4);
+        } else {
+            auto v = row.getString(column);
+            if (!v.has_value()) return;
+            string_view low = v.value().substr(0, STRING_BOUND_BYTES);
+            string high = upperBound(v.value());
+            bool bounded = !(v.value().size() > STRING_BOUND_BYTES && high.empty());
+            uint8_t* h = e + 2 + STRING_BOUND_BYTES;
+            if (!first) {
+                string_view oldLow(reinterpret_cast<const char*>(e + 2), e[1]);
+                if (oldLow < low) low = oldLow;
+                if (h[0] == NO_UPPER_BOUND) bounded = false;
+                else if (bounded) {
+                    string_view oldHigh(reinterpret_cast<const char*>(h + 1), h[0]);
+                    if (oldHigh > high) high = string(oldHigh);
+                }
+            }
+            string lowCopy(low); // low may point into e
+            memset(e + 1, 0, 2 + 2 * STRING_BOUND_BYTES);
+            e[1] = static_cast<uint8_t>(lowCopy.size());
+            memcpy(e + 2, lowCopy.data(), lowCopy.size());
+            h[0] = bounded ? static_cast<uint8_t>(high.size()) : NO_UPPER_BOUND;
+            if (bounded) memcpy(h + 1, high.data(), high.size());
+            bloomAdd(e + rangeBytes(type), hashString(v.value()));
+        }
+        e[0] = ZONE_RANGE;
+    }
+
+    void ZoneMap::update(uint32_t pageIndex, const Page& page, const RowLayout* layout) {
+        if (stride == 0) return;
+        vector<uint8_t> zone(stride, 0);
+        for (size_t c = 0; c < types.size(); ++c) zone[offset[c]] = ZONE_EMPTY;
+
+        for (uint16_t s = 0; s < page.slots.size(); ++s) {
+            const uint8_t* ptr = nullptr;
+            uint16_t len = 0;
+            if (!page.recordBytes(s, ptr, len)) continue;
+            RecordView row(ptr, len, layout);
+            for (size_t c = 0; c < types.size(); ++c)
+                include(zone.data() + offset[c], types[c], row, static_cast<uint16_t>(c));
+        }
+
+        size_t at = static_cast<size_t>(pageIndex) * stride;
+        if (at + stride > entries.size()) entries.resize(at + stride, ZONE_UNKNOWN); // skipped pages: unknown
+        else if (memcmp(entries.data() + at, zone.data(), stride) == 0) return;
+        memcpy(entries.data() + at, zone.data(), stride);
+        markDirty();
+    }
+
+    void ZoneMap::widen(uint32_t pageIndex, const Page& page, uint16_t slotID, const RowLayout* layout) {
+        if (pageIndex >= pageCount()) {
+            update(pageIndex, page, layout);
+            return;
+        }
+        const uint8_t* ptr = nullptr;
+        uint16_t len = 0;
+        if (!page.recordBytes(slotID, ptr, len)) return;
+        RecordView row(ptr, len, layout);
+        uint8_t* zone = entries.data() + static_cast<size_t>(pageIndex) * stride;
+        vector<uint8_t> before(zone, zone + stride);
+        for (size_t c = 0; c < types.size(); ++c)
+            include(zone + offset[c], types[c], row, static_cast<uint16_t>(c));
+        if (memcmp(before.data(), zone, stride) != 0) markDirty();
+    }
+
+    void ZoneMap::truncate(uint32_t pages) {
+        if (pages >= pageCount()) return;
+        entries.resize(static_cast<size_t>(pages) * stride);
+        markDirty();
+    }
+
+    // Mirrors ScanPredicate: the page may match if some value in [min, max] could.
+    // FLOAT bounds are widened by the predicate's equality tolerance. Equality on an
+    // INT or STRING column also has to pass the page's Bloom filter.
+    bool ZoneMap::mayMatch(uint32_t pageIndex, const ScanPredicate& where) const {
+        if (pageIndex >= pageCount() || where.column >= types.size()) return true;
+        const uint8_t* e = entries.data() + static_cast<size_t>(pageIndex) * stride + offset[where.column];
+        if (e[0] == ZONE_UNKNOWN) return true;
+        if (e[0] == ZONE_EMPTY) return false;
+        if (where.op == CompareOp::BETWEEN) {
+            // both ends: some value >= low and some value <= high
+            ScanPredicate low = where, high = where;
+            low.op = CompareOp::GE;
+            high.op = CompareOp::LE;
+            high.value = where.high;
+            return mayMatch(pageIndex, low) && mayMatch(pageIndex, high);
+        }
+
+        // cmpLow: min compared to the value, cmpHigh: max compared to the value (-1, 0, 1)
+        int cmpLow = 0, cmpHigh = 0;
+        bool highBounded = true;
+        DataType type = types[where.column];
+        if (type == DataType::INT) {
+            if (!holds_alternative<int>(where.value)) return true;
+            int32_t lo = 0, hi = 0, v = get<int>(where.value);
+            memcpy(&lo, e + 1, 4);
+            memcpy(&hi, e + 5, 4);
+            cmpLow = (lo < v) ? -1 : (lo > v);
+            cmpHigh = (hi < v) ? -1 : (hi > v);
+        } else if (type == DataType::FLOAT) {
+            if (!holds_alternative<float>(where.value)) return true;
+            float lo = 0, hi = 0, v = get<float>(where.value);
+            memcpy(&lo, e + 1, 4);
+            memcpy(&hi, e + 5, 4);
+            lo -= 0.0001f;
+            hi += 0.0001f;
+            cmpLow = (lo < v) ? -1 : (lo > v);
+            cmpHigh = (hi < v) ? -1 : (hi > v);
+        } else {
+            if (!holds_alternative<string>(where.value)) return true;
+            string_view v = get<string>(where.value);
+            string_view lo(reinterpret_cast<const char*>(e + 2), e[1]);
+            const uint8_t* h = e + 2 + STRING_BOUND_BYTES;
+            highBounded = h[0] != NO_UPPER_BOUND;
+            // min is a prefix of the real min (<=); max is above the real max when rounded up
+            int c = lo.compare(v);
+            cmpLow = (c < 0) ? -1 : (c > 0);
+            if (highBounded) {
+                c = string_view(reinterpret_cast<const char*>(h + 1), h[0]).compare(v);
+                cmpHigh = (c < 0) ? -1 : (c > 0);
+            }
+        }
+
+        switch (where.op) {
+            case CompareOp::EQ:
+                if (cmpLow > 0 || (highBounded && cmpHigh < 0)) return false;
+                if (type == DataType::INT) return bloomMayContain(e + rangeBytes(type), hashInt(get<int>(where.value)));
+                if (type == DataType::STRING) return bloomMayContain(e + rangeBytes(type), hashString(get<string>(where.value)));
+                return true;
+            case CompareOp::LT: return cmpLow < 0;
+            case CompareOp::LE: return cmpLow <= 0;
+            case CompareOp::GT: return !highBounded || cmpHigh > 0;
+            case CompareOp::GE: return !highBounded || cmpHigh >= 0;
+            case CompareOp::BETWEEN: break; // split above
+        }
+        return true;
+    }
+
+} // namespace ChronoDB
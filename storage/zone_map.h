@@ -0,0 +1,82 @@
+#ifndef CHRONODB_ZONE_MAP_H
+#define CHRONODB_ZONE_MAP_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "../utils/types.h"
+#include "page.h"
+#include "record_view.h"
+using namespace std;
+
+namespace ChronoDB {
+
+    // Zone map for a HEAP table: the min and max of every column on every page, so a
+    // scan with a predicate can skip pages whose range cannot match without reading them.
+    // INT and STRING entries also carry a Bloom filter of the page's values, which rules
+    // pages out for equality lookups whose value falls inside the range.
+    //
+    // A page's zones are recomputed from its live rows whenever the engine writes it, so
+    // deletes and updates narrow them again; a write that only adds a row widens them.
+    // STRING bounds keep the first STRING_BOUND_BYTES bytes: the min as a prefix, the
+    // max rounded up past every string with that prefix (or unbounded).
+    //
+    // Per page and column, one entry:
+    //   INT         : state:u8 | min:4 | max:4 | bloom:256
+    //   FLOAT       : state:u8 | min:4 | max:4
+    //   STRING      : state:u8 | minLength:u8 | min:16 | maxLength:u8 (0xFF: none) | max:16 | bloom:256
+    // state 0: not summarized (may match), 1: no value on the page, 2: min/max hold
+    // File layout (<table>.zmap), written at checkpoint:
+    //   "CZMP" | version:u8 | clean:u8 | columns:u8 | pad:u8 | pageCount:u32 | entries | crc32:u32
+    // The first change after a checkpoint clears the clean flag in the file: unlike the
+    // free-space map, a stale zone would hide rows, so a map that was not closed cleanly
+    // is rebuilt from the pages.
+    class ZoneMap {
+    public:
+        static constexpr size_t STRING_BOUND_BYTES = 16;
+        static constexpr size_t BLOOM_BYTES = 256;   // 2048 bits per column and page
+        static constexpr uint32_t BLOOM_HASHES = 4;
+
+        ZoneMap() = default;
+        ZoneMap(const string& filePath, const vector<DataType>& columnTypes);
+
+        bool load(uint32_t expectedPages);  // false if missing, damaged, out of date or not clean
+        bool checkpoint();                  // snapshot + clean flag
+
+        // Summarizes the live rows of a page (layout: as for RecordView); grows the map
+        void update(uint32_t pageIndex, const Page& page, const RowLayout* layout);
+        // Same after the page's only change was the row added in slotID: O(columns)
+        void widen(uint32_t pageIndex, const Page& page, uint16_t slotID, const RowLayout* layout);
+        void truncate(uint32_t pages);
+        // false only if no row on the page can match (pages not in the map may)
+        bool mayMatch(uint32_t pageIndex, const ScanPredicate& where) const;
+
+        uint32_t pageCount() const { return stride == 0 ? 0 : static_cast<uint32_t>(entries.size() / stride); }
+        bool isDirty() const { return dirty; }
+
+    private:
+        static constexpr uint8_t VERSION = 2;
+        static constexpr size_t HEADER_BYTES = 12;
+        static constexpr uint8_t ZONE_UNKNOWN = 0, ZONE_EMPTY = 1, ZONE_RANGE = 2;
+        static constexpr uint8_t NO_UPPER_BOUND = 0xFF;
+
+        string path;
+        vector<DataType> types;
+        vector<size_t> offset;  // of each column's entry within a page
+        size_t stride = 0;      // bytes per page
+        vector<uint8_t> entries;
+        bool dirty = false;
+
+        void markDirty();
+        static string upperBound(string_view max);
+        static void include(uint8_t* entry, DataType type, const RecordView& row, uint16_t column);
+        static size_t rangeBytes(DataType type) { return type == DataType::STRING ? 3 + 2 * STRING_BOUND_BYTES : 9; }
+        static size_t bloomBytes(DataType type) { return type == DataType::FLOAT ? 0 : BLOOM_BYTES; }
+        static void bloomAdd(uint8_t* bloom, uint64_t hash);
+        static bool bloomMayContain(const uint8_t* bloom, uint64_t hash);
+    };
+
+} // namespace ChronoDB
+
+#endif // CHRONODB_ZONE_MAP_H